@@ -0,0 +1,81 @@
+#include "AckBitmapAccumulator.h"
+
+namespace mqttsn {
+
+bool AckBitmapAccumulator::isEmpty() const
+{
+    return baseMsgId == 0;
+}
+
+bool AckBitmapAccumulator::isFull() const
+{
+    // a full window cannot grow any further
+    return mask == UINT32_MAX;
+}
+
+bool AckBitmapAccumulator::fits(uint16_t msgId) const
+{
+    // the base itself fits, so a duplicate of it is already covered
+    return !isEmpty() && msgId >= baseMsgId && msgId - baseMsgId <= WINDOW_SIZE;
+}
+
+bool AckBitmapAccumulator::follows(uint16_t msgId) const
+{
+    // a stream whose consecutive IDs are further apart than the window can never share a batch
+    return lastMsgId != 0 && msgId > lastMsgId && msgId - lastMsgId <= WINDOW_SIZE;
+}
+
+void AckBitmapAccumulator::add(uint16_t msgId)
+{
+    if (msgId == 0) {
+        throw omnetpp::cRuntimeError("Message ID 0 cannot be acknowledged in a bitmap");
+    }
+
+    if (isEmpty()) {
+        // start a new batch based on this message ID
+        baseMsgId = msgId;
+        mask = 0;
+        lastMsgId = msgId;
+        return;
+    }
+
+    if (!fits(msgId)) {
+        throw omnetpp::cRuntimeError("Message ID %u is outside the bitmap window of base %u", msgId, baseMsgId);
+    }
+
+    if (msgId != baseMsgId) {
+        mask |= (uint32_t) 1 << (msgId - baseMsgId - 1);
+    }
+
+    lastMsgId = std::max(lastMsgId, msgId);
+}
+
+void AckBitmapAccumulator::skip(uint16_t msgId)
+{
+    // acknowledged outside any batch; still the reference for the next ID
+    lastMsgId = msgId;
+}
+
+void AckBitmapAccumulator::clear()
+{
+    baseMsgId = 0;
+    mask = 0;
+}
+
+void AckBitmapAccumulator::reset()
+{
+    clear();
+    lastMsgId = 0;
+}
+
+uint16_t AckBitmapAccumulator::getBaseMsgId() const
+{
+    return baseMsgId;
+}
+
+uint32_t AckBitmapAccumulator::getMask() const
+{
+    return mask;
+}
+
+} /* namespace mqttsn */
@@ -0,0 +1,39 @@
+#ifndef HELPERS_ACKBITMAPACCUMULATOR_H_
+#define HELPERS_ACKBITMAPACCUMULATOR_H_
+
+#include <omnetpp.h>
+
+namespace mqttsn {
+
+// batch of acknowledged message IDs; bit i of the mask covers the base plus one plus i
+class AckBitmapAccumulator
+{
+    private:
+        static constexpr unsigned WINDOW_SIZE = 32;
+
+        uint16_t baseMsgId = 0;
+        uint32_t mask = 0;
+        uint16_t lastMsgId = 0;
+
+    public:
+        AckBitmapAccumulator() {};
+
+        bool isEmpty() const;
+        bool isFull() const;
+        bool fits(uint16_t msgId) const;
+        bool follows(uint16_t msgId) const;
+
+        void add(uint16_t msgId);
+        void skip(uint16_t msgId);
+        void clear();
+        void reset();
+
+        uint16_t getBaseMsgId() const;
+        uint32_t getMask() const;
+
+        ~AckBitmapAccumulator() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* HELPERS_ACKBITMAPACCUMULATOR_H_ */
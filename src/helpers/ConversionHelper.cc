@@ -78,4 +78,36 @@ std::string ConversionHelper::topicIdTypeToString(TopicIdType idType)
     }
 }
 
+PayloadCodecType ConversionHelper::stringToPayloadCodecType(const std::string& codec)
+{
+    // convert from a string identifier to a payload codec type enumeration
+    if (codec == "none") {
+        return PayloadCodecType::NO_CODEC;
+    }
+    else if (codec == "dictionary") {
+        return PayloadCodecType::DICTIONARY_CODEC;
+    }
+
+    throw omnetpp::cRuntimeError("Invalid payload codec");
+}
+
+GatewaySelectionPolicyType ConversionHelper::stringToGatewaySelectionPolicyType(const std::string& policy)
+{
+    // convert from a string identifier to a gateway selection policy type enumeration
+    if (policy == "random") {
+        return GatewaySelectionPolicyType::RANDOM_POLICY;
+    }
+    else if (policy == "lowestRtt") {
+        return GatewaySelectionPolicyType::LOWEST_RTT_POLICY;
+    }
+    else if (policy == "leastLoaded") {
+        return GatewaySelectionPolicyType::LEAST_LOADED_POLICY;
+    }
+    else if (policy == "sticky") {
+        return GatewaySelectionPolicyType::STICKY_POLICY;
+    }
+
+    throw omnetpp::cRuntimeError("Invalid gateway selection policy");
+}
+
 } /* namespace mqttsn */
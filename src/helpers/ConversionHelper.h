@@ -4,6 +4,8 @@
 #include "BaseHelper.h"
 #include "types/shared/QoS.h"
 #include "types/shared/TopicIdType.h"
+#include "types/shared/PayloadCodecType.h"
+#include "types/client/GatewaySelectionPolicyType.h"
 
 namespace mqttsn {
 
@@ -14,6 +16,8 @@ class ConversionHelper : public BaseHelper
         static int qosToInt(QoS value);
         static TopicIdType stringToTopicIdType(const std::string& idType);
         static std::string topicIdTypeToString(TopicIdType idType);
+        static PayloadCodecType stringToPayloadCodecType(const std::string& codec);
+        static GatewaySelectionPolicyType stringToGatewaySelectionPolicyType(const std::string& policy);
 };
 
 } /* namespace mqttsn */
@@ -0,0 +1,101 @@
+#include "DuplicateDetector.h"
+
+namespace mqttsn {
+
+DuplicateDetector::DuplicateDetector(unsigned size)
+{
+    if (size == 0) {
+        throw omnetpp::cRuntimeError("Duplicate detection window must not be empty");
+    }
+
+    // round up to whole words
+    unsigned wordCount = (size + WORD_BITS - 1) / WORD_BITS;
+
+    windowSize = wordCount * WORD_BITS;
+    words.assign(wordCount, 0);
+}
+
+void DuplicateDetector::setBit(unsigned identifier)
+{
+    unsigned bit = identifier % windowSize;
+
+    words[bit / WORD_BITS] |= (uint64_t) 1 << (bit % WORD_BITS);
+}
+
+bool DuplicateDetector::getBit(unsigned identifier) const
+{
+    unsigned bit = identifier % windowSize;
+
+    return (words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
+
+void DuplicateDetector::clearBits(unsigned start, unsigned length)
+{
+    // clear bit positions [start, start + length) within the window, a word at a time
+    unsigned end = start + length;
+    unsigned firstWord = start / WORD_BITS;
+    unsigned lastWord = (end - 1) / WORD_BITS;
+
+    uint64_t headMask = ~(uint64_t) 0 << (start % WORD_BITS);
+    uint64_t tailMask = ~(uint64_t) 0 >> (WORD_BITS - 1 - (end - 1) % WORD_BITS);
+
+    if (firstWord == lastWord) {
+        words[firstWord] &= ~(headMask & tailMask);
+        return;
+    }
+
+    words[firstWord] &= ~headMask;
+    std::fill(words.begin() + firstWord + 1, words.begin() + lastWord, 0);
+    words[lastWord] &= ~tailMask;
+}
+
+void DuplicateDetector::clearIdentifiers(unsigned firstIdentifier, unsigned count)
+{
+    unsigned start = firstIdentifier % windowSize;
+
+    // the range may wrap around the end of the window
+    while (count > 0) {
+        unsigned length = std::min(count, windowSize - start);
+        clearBits(start, length);
+
+        start = 0;
+        count -= length;
+    }
+}
+
+SightingType DuplicateDetector::markSeen(unsigned identifier)
+{
+    if (identifier > highestIdentifier) {
+        // slide the window; the slots of the skipped identifiers are reused
+        if (identifier - highestIdentifier >= windowSize) {
+            std::fill(words.begin(), words.end(), 0);
+        }
+        else if (identifier - highestIdentifier > 1) {
+            clearIdentifiers(highestIdentifier + 1, identifier - highestIdentifier - 1);
+        }
+
+        highestIdentifier = identifier;
+        setBit(identifier);
+
+        return SightingType::NEW_SIGHTING;
+    }
+
+    if (highestIdentifier - identifier >= windowSize) {
+        return SightingType::STALE_SIGHTING;
+    }
+
+    if (getBit(identifier)) {
+        return SightingType::DUPLICATE_SIGHTING;
+    }
+
+    setBit(identifier);
+
+    return SightingType::NEW_SIGHTING;
+}
+
+unsigned DuplicateDetector::getWindowSize() const
+{
+    return windowSize;
+}
+
+} /* namespace mqttsn */
@@ -0,0 +1,36 @@
+#ifndef HELPERS_DUPLICATEDETECTOR_H_
+#define HELPERS_DUPLICATEDETECTOR_H_
+
+#include <omnetpp.h>
+#include "types/shared/SightingType.h"
+
+namespace mqttsn {
+
+// sliding window over increasing identifiers; memory depends on the window size only
+class DuplicateDetector
+{
+    private:
+        static constexpr unsigned WORD_BITS = 64;
+
+        std::vector<uint64_t> words;
+        unsigned windowSize = 0;
+        unsigned highestIdentifier = 0;
+
+        void setBit(unsigned identifier);
+        bool getBit(unsigned identifier) const;
+        void clearBits(unsigned start, unsigned length);
+        void clearIdentifiers(unsigned firstIdentifier, unsigned count);
+
+    public:
+        DuplicateDetector(unsigned size = 4096);
+
+        SightingType markSeen(unsigned identifier);
+
+        unsigned getWindowSize() const;
+
+        ~DuplicateDetector() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* HELPERS_DUPLICATEDETECTOR_H_ */
@@ -0,0 +1,139 @@
+#include "GatewaySelectionPolicy.h"
+
+namespace mqttsn {
+
+std::map<uint8_t, GatewayInfo>::const_iterator GatewaySelectionPolicy::selectRandom(const std::map<uint8_t, GatewayInfo>& gateways,
+                                                                                     omnetpp::cRNG* rng)
+{
+    auto it = gateways.begin();
+    std::advance(it, omnetpp::intuniform(rng, 0, gateways.size() - 1));
+
+    return it;
+}
+
+std::map<uint8_t, GatewayInfo>::const_iterator GatewaySelectionPolicy::selectLowestRtt(const std::map<uint8_t, GatewayInfo>& gateways)
+{
+    auto selectedIt = gateways.begin();
+
+    for (auto it = gateways.begin(); it != gateways.end(); ++it) {
+        // unmeasured gateways come first so that each one is probed at least once
+        if (it->second.smoothedRtt == 0) {
+            return it;
+        }
+
+        if (it->second.smoothedRtt < selectedIt->second.smoothedRtt) {
+            selectedIt = it;
+        }
+    }
+
+    return selectedIt;
+}
+
+GatewaySelectionPolicy* GatewaySelectionPolicy::create(GatewaySelectionPolicyType policyType, double hysteresis)
+{
+    switch (policyType) {
+        case GatewaySelectionPolicyType::RANDOM_POLICY:
+            return new RandomGatewaySelectionPolicy();
+
+        case GatewaySelectionPolicyType::LOWEST_RTT_POLICY:
+            return new LowestRttGatewaySelectionPolicy();
+
+        case GatewaySelectionPolicyType::LEAST_LOADED_POLICY:
+            return new LeastLoadedGatewaySelectionPolicy();
+
+        case GatewaySelectionPolicyType::STICKY_POLICY:
+            return new StickyGatewaySelectionPolicy(hysteresis);
+
+        default:
+            throw omnetpp::cRuntimeError("Unknown gateway selection policy: %d", policyType);
+    }
+}
+
+GatewaySelectionPolicyType RandomGatewaySelectionPolicy::getType() const
+{
+    return GatewaySelectionPolicyType::RANDOM_POLICY;
+}
+
+uint8_t RandomGatewaySelectionPolicy::select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng)
+{
+    return selectRandom(gateways, rng)->first;
+}
+
+GatewaySelectionPolicyType LowestRttGatewaySelectionPolicy::getType() const
+{
+    return GatewaySelectionPolicyType::LOWEST_RTT_POLICY;
+}
+
+uint8_t LowestRttGatewaySelectionPolicy::select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng)
+{
+    return selectLowestRtt(gateways)->first;
+}
+
+uint8_t LeastLoadedGatewaySelectionPolicy::getComparableLoadHint(const GatewayInfo& gatewayInfo)
+{
+    // gateways of unknown load rank behind every gateway reporting one
+    return gatewayInfo.loadHint == 0 ? UINT8_MAX : gatewayInfo.loadHint;
+}
+
+GatewaySelectionPolicyType LeastLoadedGatewaySelectionPolicy::getType() const
+{
+    return GatewaySelectionPolicyType::LEAST_LOADED_POLICY;
+}
+
+uint8_t LeastLoadedGatewaySelectionPolicy::select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng)
+{
+    uint8_t minLoadHint = UINT8_MAX;
+    int candidates = 0;
+
+    for (const auto& gateway : gateways) {
+        uint8_t loadHint = getComparableLoadHint(gateway.second);
+
+        if (loadHint < minLoadHint) {
+            minLoadHint = loadHint;
+            candidates = 0;
+        }
+
+        if (loadHint == minLoadHint) {
+            candidates++;
+        }
+    }
+
+    // spread clients evenly over equally loaded gateways; hints are only refreshed on advertisements
+    int index = omnetpp::intuniform(rng, 0, candidates - 1);
+
+    for (const auto& gateway : gateways) {
+        if (getComparableLoadHint(gateway.second) == minLoadHint && index-- == 0) {
+            return gateway.first;
+        }
+    }
+
+    throw omnetpp::cRuntimeError("Unexpected error: No gateway selected");
+}
+
+GatewaySelectionPolicyType StickyGatewaySelectionPolicy::getType() const
+{
+    return GatewaySelectionPolicyType::STICKY_POLICY;
+}
+
+uint8_t StickyGatewaySelectionPolicy::select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng)
+{
+    auto bestIt = selectLowestRtt(gateways);
+    auto currentIt = hasSelection ? gateways.find(selectedGatewayId) : gateways.end();
+
+    // stay with the current gateway unless a measured one is clearly faster
+    if (currentIt != gateways.end()) {
+        double currentRtt = currentIt->second.smoothedRtt;
+        double bestRtt = bestIt->second.smoothedRtt;
+
+        if (currentRtt == 0 || bestRtt == 0 || bestRtt >= currentRtt * (1 - hysteresis)) {
+            bestIt = currentIt;
+        }
+    }
+
+    hasSelection = true;
+    selectedGatewayId = bestIt->first;
+
+    return selectedGatewayId;
+}
+
+} /* namespace mqttsn */
@@ -0,0 +1,71 @@
+#ifndef HELPERS_GATEWAYSELECTIONPOLICY_H_
+#define HELPERS_GATEWAYSELECTIONPOLICY_H_
+
+#include <omnetpp.h>
+#include "inet/networklayer/common/L3Address.h"
+#include "inet/clock/contract/ClockTime.h"
+#include "types/client/GatewayInfo.h"
+#include "types/client/GatewaySelectionPolicyType.h"
+
+namespace mqttsn {
+
+class GatewaySelectionPolicy
+{
+    protected:
+        static std::map<uint8_t, GatewayInfo>::const_iterator selectRandom(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng);
+        static std::map<uint8_t, GatewayInfo>::const_iterator selectLowestRtt(const std::map<uint8_t, GatewayInfo>& gateways);
+
+    public:
+        virtual GatewaySelectionPolicyType getType() const = 0;
+
+        // returns the ID of the chosen gateway; the map must not be empty
+        virtual uint8_t select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng) = 0;
+
+        static GatewaySelectionPolicy* create(GatewaySelectionPolicyType policyType, double hysteresis);
+
+        virtual ~GatewaySelectionPolicy() {};
+};
+
+class RandomGatewaySelectionPolicy : public GatewaySelectionPolicy
+{
+    public:
+        virtual GatewaySelectionPolicyType getType() const override;
+        virtual uint8_t select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng) override;
+};
+
+class LowestRttGatewaySelectionPolicy : public GatewaySelectionPolicy
+{
+    public:
+        virtual GatewaySelectionPolicyType getType() const override;
+        virtual uint8_t select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng) override;
+};
+
+class LeastLoadedGatewaySelectionPolicy : public GatewaySelectionPolicy
+{
+    private:
+        static uint8_t getComparableLoadHint(const GatewayInfo& gatewayInfo);
+
+    public:
+        virtual GatewaySelectionPolicyType getType() const override;
+        virtual uint8_t select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng) override;
+};
+
+class StickyGatewaySelectionPolicy : public GatewaySelectionPolicy
+{
+    private:
+        // minimum relative RTT improvement before leaving the current gateway
+        double hysteresis;
+
+        bool hasSelection = false;
+        uint8_t selectedGatewayId = 0;
+
+    public:
+        StickyGatewaySelectionPolicy(double hysteresis) : hysteresis(hysteresis) {};
+
+        virtual GatewaySelectionPolicyType getType() const override;
+        virtual uint8_t select(const std::map<uint8_t, GatewayInfo>& gateways, omnetpp::cRNG* rng) override;
+};
+
+} /* namespace mqttsn */
+
+#endif /* HELPERS_GATEWAYSELECTIONPOLICY_H_ */
@@ -0,0 +1,90 @@
+#include "IdAllocator.h"
+
+namespace mqttsn {
+
+IdAllocator::IdAllocator(bool allowMaxValue)
+{
+    // ID=0 is considered invalid; ID=UINT16_MAX can be considered invalid
+    maxValue = allowMaxValue ? UINT16_MAX : UINT16_MAX - 1;
+    usedBits.assign(WORD_COUNT, 0);
+
+    // permanently mark the invalid IDs as used without counting them
+    usedBits[0] |= 1;
+
+    if (!allowMaxValue) {
+        usedBits[WORD_COUNT - 1] |= 1ULL << (WORD_BITS - 1);
+    }
+}
+
+void IdAllocator::markUsed(uint16_t id)
+{
+    usedBits[id / WORD_BITS] |= 1ULL << (id % WORD_BITS);
+    usedCount++;
+}
+
+bool IdAllocator::allocate(uint16_t& id)
+{
+    if (isExhausted()) {
+        return false;
+    }
+
+    // continue right after the last allocated ID so that released IDs are not reused immediately
+    uint32_t startId = (currentId >= maxValue) ? 1 : currentId + 1;
+    uint32_t wordIndex = startId / WORD_BITS;
+    uint64_t freeBits = ~usedBits[wordIndex] & (~0ULL << (startId % WORD_BITS));
+
+    // scan whole words, wrapping around once to cover the IDs before the start
+    for (uint32_t i = 0; i <= WORD_COUNT; i++) {
+        if (freeBits != 0) {
+            id = wordIndex * WORD_BITS + __builtin_ctzll(freeBits);
+            markUsed(id);
+            currentId = id;
+
+            return true;
+        }
+
+        wordIndex = (wordIndex + 1) % WORD_COUNT;
+        freeBits = ~usedBits[wordIndex];
+    }
+
+    throw omnetpp::cRuntimeError("Identifier bitmap and used counter are out of sync");
+}
+
+void IdAllocator::reserve(uint16_t id)
+{
+    if (id == 0 || id > maxValue) {
+        throw omnetpp::cRuntimeError("Invalid identifier %u cannot be reserved", id);
+    }
+
+    if (!isUsed(id)) {
+        markUsed(id);
+    }
+}
+
+void IdAllocator::release(uint16_t id)
+{
+    if (id == 0 || id > maxValue || !isUsed(id)) {
+        return;
+    }
+
+    usedBits[id / WORD_BITS] &= ~(1ULL << (id % WORD_BITS));
+    usedCount--;
+}
+
+bool IdAllocator::isUsed(uint16_t id) const
+{
+    return (usedBits[id / WORD_BITS] >> (id % WORD_BITS)) & 1;
+}
+
+bool IdAllocator::isExhausted() const
+{
+    // the valid range of IDs goes from one to the maximum value
+    return usedCount >= maxValue;
+}
+
+uint32_t IdAllocator::size() const
+{
+    return usedCount;
+}
+
+} /* namespace mqttsn */
@@ -0,0 +1,38 @@
+#ifndef HELPERS_IDALLOCATOR_H_
+#define HELPERS_IDALLOCATOR_H_
+
+#include <omnetpp.h>
+
+namespace mqttsn {
+
+class IdAllocator
+{
+    private:
+        static constexpr uint32_t WORD_BITS = 64;
+        static constexpr uint32_t WORD_COUNT = (UINT16_MAX + 1) / WORD_BITS;
+
+        std::vector<uint64_t> usedBits;
+        uint16_t maxValue;
+        uint32_t usedCount = 0;
+        uint16_t currentId = 0;
+
+    protected:
+        void markUsed(uint16_t id);
+
+    public:
+        IdAllocator(bool allowMaxValue = true);
+
+        bool allocate(uint16_t& id);
+        void reserve(uint16_t id);
+        void release(uint16_t id);
+
+        bool isUsed(uint16_t id) const;
+        bool isExhausted() const;
+        uint32_t size() const;
+
+        ~IdAllocator() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* HELPERS_IDALLOCATOR_H_ */
@@ -1,8 +1,9 @@
 #include "PacketHelper.h"
 #include "inet/common/TimeTag_m.h"
 #include "tags/IdentifierTag.h"
+#include "tags/BatchTag.h"
 #include "messages/MqttSNRegister.h"
-#include "messages/MqttSNPublish.h"
+#include "messages/MqttSNBaseWithReturnCode.h"
 #include "messages/MqttSNBaseWithMsgId.h"
 #include "messages/MqttSNMsgIdWithTopicIdPlus.h"
 
@@ -24,7 +25,14 @@ inet::Packet* PacketHelper::getRegisterPacket(uint16_t topicId, uint16_t msgId,
 }
 
 inet::Packet* PacketHelper::getPublishPacket(bool dupFlag, QoS qosFlag, bool retainFlag, TopicIdType topicIdTypeFlag, uint16_t topicId,
-                                             uint16_t msgId, const std::string& data, const TagInfo& tagInfo)
+                                             uint16_t msgId, const std::string& data, const TagInfo& tagInfo, bool compressionFlag)
+{
+    return getPublishPacket(dupFlag, qosFlag, retainFlag, topicIdTypeFlag, topicId, msgId, std::make_shared<const std::string>(data), tagInfo,
+                            compressionFlag);
+}
+
+inet::Packet* PacketHelper::getPublishPacket(bool dupFlag, QoS qosFlag, bool retainFlag, TopicIdType topicIdTypeFlag, uint16_t topicId,
+                                             uint16_t msgId, const PayloadBuffer& data, const TagInfo& tagInfo, bool compressionFlag)
 {
     const auto& payload = inet::makeShared<MqttSNPublish>();
     payload->setMsgType(MsgType::PUBLISH);
@@ -32,6 +40,7 @@ inet::Packet* PacketHelper::getPublishPacket(bool dupFlag, QoS qosFlag, bool ret
     payload->setQoSFlag(qosFlag);
     payload->setRetainFlag(retainFlag);
     payload->setTopicIdTypeFlag(topicIdTypeFlag);
+    payload->setCompressionFlag(compressionFlag);
     payload->setTopicId(topicId);
     payload->setMsgId(msgId);
     payload->setData(data);
@@ -45,43 +54,60 @@ inet::Packet* PacketHelper::getPublishPacket(bool dupFlag, QoS qosFlag, bool ret
         payload->addTag<IdentifierTag>()->setIdentifier(tagInfo.identifier);
     }
 
+    if (tagInfo.samples != nullptr) {
+        payload->addTag<BatchTag>()->setSamples(tagInfo.samples);
+    }
+
     inet::Packet* packet = new inet::Packet("PublishPacket");
     packet->insertAtBack(payload);
 
     return packet;
 }
 
-inet::Packet* PacketHelper::getBaseWithMsgIdPacket(MsgType msgType, uint16_t msgId)
+TagInfo PacketHelper::getTagInfo(const inet::Ptr<const MqttSNPublish>& payload)
 {
-    const auto& payload = inet::makeShared<MqttSNBaseWithMsgId>();
-    payload->setMsgType(msgType);
-    payload->setMsgId(msgId);
-    payload->setChunkLength(inet::B(payload->getLength()));
+    TagInfo tagInfo;
 
-    std::string packetName;
+    if (const auto& creationTimeTag = payload->findTag<inet::CreationTimeTag>()) {
+        tagInfo.timestamp = inet::ClockTime::SIMTIME_AS_CLOCKTIME(creationTimeTag->getCreationTime());
+    }
 
-    switch(msgType) {
-        case MsgType::PUBREC:
-            packetName = "PubRecPacket";
-            break;
+    if (const auto& identifierTag = payload->findTag<IdentifierTag>()) {
+        tagInfo.identifier = identifierTag->getIdentifier();
+    }
 
-        case MsgType::PUBREL:
-            packetName = "PubRelPacket";
-            break;
+    if (const auto& batchTag = payload->findTag<BatchTag>()) {
+        tagInfo.samples = batchTag->getSamples();
+    }
 
-        case MsgType::PUBCOMP:
-            packetName = "PubCompPacket";
-            break;
+    return tagInfo;
+}
 
-        case MsgType::UNSUBACK:
-            packetName = "UnsubAckPacket";
-            break;
+inet::Packet* PacketHelper::getBasePacket(MsgType msgType)
+{
+    inet::Packet* packet = new inet::Packet(getPacketName(msgType, "BasePacket"));
+    packet->insertAtBack(getPrototypeCopy<MqttSNBase>(msgType));
 
-        default:
-            packetName = "BaseWithMsgId";
-    }
+    return packet;
+}
 
-    inet::Packet* packet = new inet::Packet(packetName.c_str());
+inet::Packet* PacketHelper::getBaseWithReturnCodePacket(MsgType msgType, ReturnCode returnCode)
+{
+    const auto& payload = getPrototypeCopy<MqttSNBaseWithReturnCode>(msgType);
+    payload->setReturnCode(returnCode);
+
+    inet::Packet* packet = new inet::Packet(getPacketName(msgType, "BaseWithReturnCodePacket"));
+    packet->insertAtBack(payload);
+
+    return packet;
+}
+
+inet::Packet* PacketHelper::getBaseWithMsgIdPacket(MsgType msgType, uint16_t msgId)
+{
+    const auto& payload = getPrototypeCopy<MqttSNBaseWithMsgId>(msgType);
+    payload->setMsgId(msgId);
+
+    inet::Packet* packet = new inet::Packet(getPacketName(msgType, "BaseWithMsgId"));
     packet->insertAtBack(payload);
 
     return packet;
@@ -89,32 +115,60 @@ inet::Packet* PacketHelper::getBaseWithMsgIdPacket(MsgType msgType, uint16_t msg
 
 inet::Packet* PacketHelper::getMsgIdWithTopicIdPlusPacket(MsgType msgType, uint16_t topicId, uint16_t msgId, ReturnCode returnCode)
 {
-    const auto& payload = inet::makeShared<MqttSNMsgIdWithTopicIdPlus>();
-    payload->setMsgType(msgType);
+    const auto& payload = getPrototypeCopy<MqttSNMsgIdWithTopicIdPlus>(msgType);
     payload->setTopicId(topicId);
     payload->setMsgId(msgId);
     payload->setReturnCode(returnCode);
-    payload->setChunkLength(inet::B(payload->getLength()));
 
-    std::string packetName;
+    inet::Packet* packet = new inet::Packet(getPacketName(msgType, "MsgIdWithTopicIdPlus"));
+    packet->insertAtBack(payload);
 
+    return packet;
+}
+
+/* Private */
+const char* PacketHelper::getPacketName(MsgType msgType, const char* defaultName)
+{
     switch(msgType) {
+        case MsgType::CONNACK:
+            return "ConnAckPacket";
+
+        case MsgType::WILLTOPICREQ:
+            return "WillTopicReqPacket";
+
+        case MsgType::WILLMSGREQ:
+            return "WillMsgReqPacket";
+
         case MsgType::REGACK:
-            packetName = "RegAckPacket";
-            break;
+            return "RegAckPacket";
 
         case MsgType::PUBACK:
-            packetName = "PubAckPacket";
-            break;
+            return "PubAckPacket";
 
-        default:
-            packetName = "MsgIdWithTopicIdPlus";
-    }
+        case MsgType::PUBCOMP:
+            return "PubCompPacket";
 
-    inet::Packet* packet = new inet::Packet(packetName.c_str());
-    packet->insertAtBack(payload);
+        case MsgType::PUBREC:
+            return "PubRecPacket";
 
-    return packet;
+        case MsgType::PUBREL:
+            return "PubRelPacket";
+
+        case MsgType::UNSUBACK:
+            return "UnsubAckPacket";
+
+        case MsgType::PINGRESP:
+            return "PingRespPacket";
+
+        case MsgType::WILLTOPICRESP:
+            return "WillTopicRespPacket";
+
+        case MsgType::WILLMSGRESP:
+            return "WillMsgRespPacket";
+
+        default:
+            return defaultName;
+    }
 }
 
 } /* namespace mqttsn */
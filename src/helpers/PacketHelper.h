@@ -9,17 +9,49 @@
 #include "types/shared/TopicIdType.h"
 #include "types/shared/ReturnCode.h"
 #include "types/shared/TagInfo.h"
+#include "types/shared/PayloadBuffer.h"
+#include "messages/MqttSNPublish.h"
+#include <array>
 
 namespace mqttsn {
 
 class PacketHelper : public BaseHelper
 {
+    private:
+        static const char* getPacketName(MsgType msgType, const char* defaultName);
+
+        // copy of an immutable, pre-validated prototype with the message type already set
+        template<typename T>
+        static inet::Ptr<T> getPrototypeCopy(MsgType msgType)
+        {
+            static std::array<inet::Ptr<const T>, 32> prototypes;
+            inet::Ptr<const T>& prototype = prototypes[msgType];
+
+            if (prototype == nullptr) {
+                const auto& payload = inet::makeShared<T>();
+                payload->setMsgType(msgType);
+                payload->setChunkLength(inet::B(payload->getLength()));
+                payload->markImmutable();
+
+                prototype = payload;
+            }
+
+            return inet::staticPtrCast<T>(prototype->dupShared());
+        }
+
     public:
         static inet::Packet* getRegisterPacket(uint16_t topicId, uint16_t msgId, const std::string& topicName);
 
         static inet::Packet* getPublishPacket(bool dupFlag, QoS qosFlag, bool retainFlag, TopicIdType topicIdTypeFlag, uint16_t topicId,
-                                              uint16_t msgId, const std::string& data, const TagInfo& tagInfo);
+                                              uint16_t msgId, const std::string& data, const TagInfo& tagInfo, bool compressionFlag = false);
+
+        static inet::Packet* getPublishPacket(bool dupFlag, QoS qosFlag, bool retainFlag, TopicIdType topicIdTypeFlag, uint16_t topicId,
+                                              uint16_t msgId, const PayloadBuffer& data, const TagInfo& tagInfo, bool compressionFlag = false);
+
+        static TagInfo getTagInfo(const inet::Ptr<const MqttSNPublish>& payload);
 
+        static inet::Packet* getBasePacket(MsgType msgType);
+        static inet::Packet* getBaseWithReturnCodePacket(MsgType msgType, ReturnCode returnCode);
         static inet::Packet* getBaseWithMsgIdPacket(MsgType msgType, uint16_t msgId);
         static inet::Packet* getMsgIdWithTopicIdPlusPacket(MsgType msgType, uint16_t topicId, uint16_t msgId, ReturnCode returnCode);
 };
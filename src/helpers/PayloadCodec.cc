@@ -0,0 +1,255 @@
+#include "PayloadCodec.h"
+#include <unordered_map>
+
+namespace mqttsn {
+
+bool PayloadCodec::compress(PayloadCodecType codecType, const std::string& data, std::string& compressedData)
+{
+    if (codecType == PayloadCodecType::NO_CODEC) {
+        return false;
+    }
+
+    compressedData.assign(1, static_cast<char>(codecType));
+    compressedData += getCodec(codecType).encode(data);
+
+    // keep the raw data when the codec identifier outweighs the savings
+    return compressedData.size() < data.size();
+}
+
+std::string PayloadCodec::decompress(const std::string& compressedData)
+{
+    if (compressedData.empty()) {
+        throw omnetpp::cRuntimeError("Compressed payload without codec identifier");
+    }
+
+    uint8_t identifier = compressedData[0] & ~BATCH_MARKER;
+
+    return getCodec(static_cast<PayloadCodecType>(identifier)).decode(compressedData.substr(1));
+}
+
+void PayloadCodec::appendSample(std::string& packedSamples, const std::string& sample)
+{
+    if (sample.size() > MAX_SAMPLE_LENGTH) {
+        throw omnetpp::cRuntimeError("Batched sample length out of range");
+    }
+
+    packedSamples += static_cast<char>(sample.size());
+    packedSamples += sample;
+}
+
+std::string PayloadCodec::compressBatch(PayloadCodecType codecType, const std::string& packedSamples)
+{
+    // unlike single payloads, batches keep the identifier even when the codec does not shrink them
+    std::string compressedData(1, static_cast<char>(codecType | BATCH_MARKER));
+    compressedData += getCodec(codecType).encode(packedSamples);
+
+    return compressedData;
+}
+
+bool PayloadCodec::isBatch(const std::string& compressedData)
+{
+    return !compressedData.empty() && (compressedData[0] & BATCH_MARKER);
+}
+
+std::vector<std::string> PayloadCodec::unpackSamples(const std::string& packedSamples)
+{
+    std::vector<std::string> samples;
+    size_t position = 0;
+
+    while (position < packedSamples.size()) {
+        size_t length = (uint8_t) packedSamples[position++];
+        if (position + length > packedSamples.size()) {
+            throw omnetpp::cRuntimeError("Truncated sample in batched payload");
+        }
+
+        samples.push_back(packedSamples.substr(position, length));
+        position += length;
+    }
+
+    if (samples.empty()) {
+        throw omnetpp::cRuntimeError("Batched payload without samples");
+    }
+
+    return samples;
+}
+
+const PayloadCodec& PayloadCodec::getCodec(PayloadCodecType codecType)
+{
+    static const NoPayloadCodec noPayloadCodec;
+    static const DictionaryPayloadCodec dictionaryPayloadCodec;
+
+    switch (codecType) {
+        case PayloadCodecType::NO_CODEC:
+            return noPayloadCodec;
+
+        case PayloadCodecType::DICTIONARY_CODEC:
+            return dictionaryPayloadCodec;
+
+        default:
+            throw omnetpp::cRuntimeError("Unknown payload codec: %d", codecType);
+    }
+}
+
+PayloadCodecType NoPayloadCodec::getType() const
+{
+    return PayloadCodecType::NO_CODEC;
+}
+
+std::string NoPayloadCodec::encode(const std::string& data) const
+{
+    return data;
+}
+
+std::string NoPayloadCodec::decode(const std::string& data) const
+{
+    return data;
+}
+
+const std::string DictionaryPayloadCodec::dictionary =
+    "{\"id\":\"sensor\",\"type\":\"value\":\"unit\":\"timestamp\":\"status\":\"ok\",\"error\":true,false,null,"
+    "\"temperature\":\"humidity\":\"pressure\":\"light\":\"battery\":\"data\":[{\"}]},\"name\":\"Data\"";
+
+void DictionaryPayloadCodec::appendLiterals(const std::string& history, size_t start, size_t end, std::string& output)
+{
+    // a control octet below 0x80 announces up to 128 literal octets
+    while (start < end) {
+        size_t count = std::min<size_t>(end - start, MAX_LITERALS);
+        output += static_cast<char>(count - 1);
+        output.append(history, start, count);
+        start += count;
+    }
+}
+
+PayloadCodecType DictionaryPayloadCodec::getType() const
+{
+    return PayloadCodecType::DICTIONARY_CODEC;
+}
+
+std::string DictionaryPayloadCodec::encode(const std::string& data) const
+{
+    // the dictionary is a virtual prefix of the data, so early matches can point into it
+    std::string history = dictionary + data;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> candidates;
+
+    auto getKey = [&history](size_t position) -> uint32_t {
+        return (uint8_t) history[position] << 16 | (uint8_t) history[position + 1] << 8 | (uint8_t) history[position + 2];
+    };
+
+    auto addCandidate = [&](size_t position) {
+        if (position + MIN_MATCH <= history.size()) {
+            candidates[getKey(position)].push_back(position);
+        }
+    };
+
+    for (size_t position = 0; position < dictionary.size(); position++) {
+        addCandidate(position);
+    }
+
+    std::string output;
+    size_t literalStart = dictionary.size();
+    size_t position = dictionary.size();
+
+    while (position < history.size()) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+
+        if (position + MIN_MATCH <= history.size()) {
+            auto it = candidates.find(getKey(position));
+
+            if (it != candidates.end()) {
+                const std::vector<uint32_t>& positions = it->second;
+                int checked = 0;
+
+                // the most recent candidates are the closest ones
+                for (auto candidate = positions.rbegin(); candidate != positions.rend() && checked < MAX_CANDIDATES; ++candidate, checked++) {
+                    size_t distance = position - *candidate;
+                    if (distance > UINT16_MAX) {
+                        break;
+                    }
+
+                    size_t length = 0;
+                    while (length < MAX_MATCH && position + length < history.size() &&
+                           history[*candidate + length] == history[position + length]) {
+                        length++;
+                    }
+
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = distance;
+                    }
+                }
+            }
+        }
+
+        if (bestLength < MIN_MATCH) {
+            addCandidate(position);
+            position++;
+            continue;
+        }
+
+        appendLiterals(history, literalStart, position, output);
+
+        // a control octet of 0x80 or above announces a match, followed by its two-octet distance
+        output += static_cast<char>(0x80 | (bestLength - MIN_MATCH));
+        output += static_cast<char>(bestDistance >> 8);
+        output += static_cast<char>(bestDistance & 0xFF);
+
+        for (size_t i = 0; i < bestLength; i++) {
+            addCandidate(position + i);
+        }
+
+        position += bestLength;
+        literalStart = position;
+    }
+
+    appendLiterals(history, literalStart, position, output);
+
+    return output;
+}
+
+std::string DictionaryPayloadCodec::decode(const std::string& data) const
+{
+    std::string history = dictionary;
+    size_t position = 0;
+
+    while (position < data.size()) {
+        uint8_t control = data[position++];
+
+        if (control < 0x80) {
+            size_t count = control + 1;
+            if (position + count > data.size()) {
+                throw omnetpp::cRuntimeError("Truncated literal run in compressed payload");
+            }
+
+            history.append(data, position, count);
+            position += count;
+            continue;
+        }
+
+        if (position + 2 > data.size()) {
+            throw omnetpp::cRuntimeError("Truncated match in compressed payload");
+        }
+
+        size_t length = (control & 0x7F) + MIN_MATCH;
+        size_t distance = (uint8_t) data[position] << 8 | (uint8_t) data[position + 1];
+        position += 2;
+
+        if (distance == 0 || distance > history.size()) {
+            throw omnetpp::cRuntimeError("Invalid match distance in compressed payload");
+        }
+
+        // copy one octet at a time since a match may overlap its own output
+        size_t start = history.size() - distance;
+        for (size_t i = 0; i < length; i++) {
+            history += history[start + i];
+        }
+
+        if (history.size() - dictionary.size() > UINT16_MAX) {
+            throw omnetpp::cRuntimeError("Decompressed payload length out of range");
+        }
+    }
+
+    return history.substr(dictionary.size());
+}
+
+} /* namespace mqttsn */
@@ -0,0 +1,66 @@
+#ifndef HELPERS_PAYLOADCODEC_H_
+#define HELPERS_PAYLOADCODEC_H_
+
+#include <omnetpp.h>
+#include "types/shared/PayloadCodecType.h"
+
+namespace mqttsn {
+
+class PayloadCodec
+{
+    public:
+        virtual PayloadCodecType getType() const = 0;
+
+        virtual std::string encode(const std::string& data) const = 0;
+        virtual std::string decode(const std::string& data) const = 0;
+
+        // compressed payloads start with the codec identifier; false when the codec would not shrink the data
+        static bool compress(PayloadCodecType codecType, const std::string& data, std::string& compressedData);
+        static std::string decompress(const std::string& compressedData);
+
+        // batched payloads set the marker bit of the codec identifier; their data is a run of length-prefixed samples
+        static constexpr uint8_t BATCH_MARKER = 0x80;
+        static constexpr size_t MAX_SAMPLE_LENGTH = UINT8_MAX;
+
+        static void appendSample(std::string& packedSamples, const std::string& sample);
+        static std::string compressBatch(PayloadCodecType codecType, const std::string& packedSamples);
+        static bool isBatch(const std::string& compressedData);
+        static std::vector<std::string> unpackSamples(const std::string& packedSamples);
+
+        static const PayloadCodec& getCodec(PayloadCodecType codecType);
+
+        virtual ~PayloadCodec() {};
+};
+
+class NoPayloadCodec : public PayloadCodec
+{
+    public:
+        virtual PayloadCodecType getType() const override;
+
+        virtual std::string encode(const std::string& data) const override;
+        virtual std::string decode(const std::string& data) const override;
+};
+
+class DictionaryPayloadCodec : public PayloadCodec
+{
+    private:
+        // fragments common in telemetry payloads; matches may reference them before any data is seen
+        static const std::string dictionary;
+
+        static constexpr uint8_t MAX_LITERALS = 0x80;
+        static constexpr uint8_t MIN_MATCH = 3;
+        static constexpr uint16_t MAX_MATCH = 0x7F + MIN_MATCH;
+        static constexpr int MAX_CANDIDATES = 16;
+
+        static void appendLiterals(const std::string& history, size_t start, size_t end, std::string& output);
+
+    public:
+        virtual PayloadCodecType getType() const override;
+
+        virtual std::string encode(const std::string& data) const override;
+        virtual std::string decode(const std::string& data) const override;
+};
+
+} /* namespace mqttsn */
+
+#endif /* HELPERS_PAYLOADCODEC_H_ */
@@ -0,0 +1,36 @@
+#include "RttEstimator.h"
+
+namespace mqttsn {
+
+void RttEstimator::addSample(double rtt)
+{
+    if (!sampled) {
+        // the first measurement initializes the estimate
+        smoothedRtt = rtt;
+        rttVariation = rtt / 2;
+        sampled = true;
+
+        return;
+    }
+
+    // the variation is updated with the previous smoothed value
+    rttVariation = (1 - BETA) * rttVariation + BETA * std::fabs(smoothedRtt - rtt);
+    smoothedRtt = (1 - ALPHA) * smoothedRtt + ALPHA * rtt;
+}
+
+bool RttEstimator::hasSamples() const
+{
+    return sampled;
+}
+
+double RttEstimator::getSmoothedRtt() const
+{
+    return smoothedRtt;
+}
+
+double RttEstimator::getTimeout() const
+{
+    return smoothedRtt + K * rttVariation;
+}
+
+} /* namespace mqttsn */
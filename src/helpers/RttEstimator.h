@@ -0,0 +1,34 @@
+#ifndef HELPERS_RTTESTIMATOR_H_
+#define HELPERS_RTTESTIMATOR_H_
+
+#include <omnetpp.h>
+
+namespace mqttsn {
+
+class RttEstimator
+{
+    private:
+        // smoothing gains and variance factor from Jacobson/Karels
+        static constexpr double ALPHA = 0.125;
+        static constexpr double BETA = 0.25;
+        static constexpr double K = 4;
+
+        double smoothedRtt = 0;
+        double rttVariation = 0;
+        bool sampled = false;
+
+    public:
+        RttEstimator() {};
+
+        void addSample(double rtt);
+
+        bool hasSamples() const;
+        double getSmoothedRtt() const;
+        double getTimeout() const;
+
+        ~RttEstimator() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* HELPERS_RTTESTIMATOR_H_ */
@@ -0,0 +1,89 @@
+#include "TopicRegistry.h"
+
+namespace mqttsn {
+
+const std::string& TopicRegistry::insert(const std::string& topicName, uint16_t topicId)
+{
+    if (findTopicName(topicId) != nullptr) {
+        throw omnetpp::cRuntimeError("Duplicate topic ID found: %d", topicId);
+    }
+
+    auto result = topicsToIds.emplace(topicName, topicId);
+    if (!result.second) {
+        throw omnetpp::cRuntimeError("Duplicate topic name found: %s", topicName.c_str());
+    }
+
+    // grow the dense table up to the new topic ID
+    if (topicId >= idsToTopics.size()) {
+        idsToTopics.resize(topicId + 1, nullptr);
+    }
+
+    // node-based map keys keep their address until erased
+    const std::string* internedName = &result.first->first;
+    idsToTopics[topicId] = internedName;
+
+    return *internedName;
+}
+
+bool TopicRegistry::findTopicId(const std::string& topicName, uint16_t& topicId) const
+{
+    auto it = topicsToIds.find(topicName);
+    if (it == topicsToIds.end()) {
+        return false;
+    }
+
+    topicId = it->second;
+    return true;
+}
+
+const std::string* TopicRegistry::findTopicName(uint16_t topicId) const
+{
+    if (topicId >= idsToTopics.size()) {
+        return nullptr;
+    }
+
+    return idsToTopics[topicId];
+}
+
+uint16_t TopicRegistry::getTopicId(const std::string& topicName) const
+{
+    uint16_t topicId;
+    if (!findTopicId(topicName, topicId)) {
+        throw omnetpp::cRuntimeError("Topic name not found in the registry");
+    }
+
+    return topicId;
+}
+
+const std::string& TopicRegistry::getTopicName(uint16_t topicId) const
+{
+    const std::string* topicName = findTopicName(topicId);
+    if (topicName == nullptr) {
+        throw omnetpp::cRuntimeError("Topic ID not found in the registry");
+    }
+
+    return *topicName;
+}
+
+std::unordered_map<std::string, uint16_t>::const_iterator TopicRegistry::begin() const
+{
+    return topicsToIds.begin();
+}
+
+std::unordered_map<std::string, uint16_t>::const_iterator TopicRegistry::end() const
+{
+    return topicsToIds.end();
+}
+
+size_t TopicRegistry::size() const
+{
+    return topicsToIds.size();
+}
+
+void TopicRegistry::clear()
+{
+    topicsToIds.clear();
+    idsToTopics.clear();
+}
+
+} /* namespace mqttsn */
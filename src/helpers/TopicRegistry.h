@@ -0,0 +1,44 @@
+#ifndef HELPERS_TOPICREGISTRY_H_
+#define HELPERS_TOPICREGISTRY_H_
+
+#include <omnetpp.h>
+#include <unordered_map>
+
+namespace mqttsn {
+
+class TopicRegistry
+{
+    private:
+        // raw topic names mapped to IDs; the keys act as the interned names
+        std::unordered_map<std::string, uint16_t> topicsToIds;
+
+        // dense table of topic IDs pointing to the interned names
+        std::vector<const std::string*> idsToTopics;
+
+    public:
+        TopicRegistry() {};
+
+        // interned names are referenced by address; copying would leave dangling pointers
+        TopicRegistry(const TopicRegistry&) = delete;
+        TopicRegistry& operator=(const TopicRegistry&) = delete;
+
+        const std::string& insert(const std::string& topicName, uint16_t topicId);
+
+        bool findTopicId(const std::string& topicName, uint16_t& topicId) const;
+        const std::string* findTopicName(uint16_t topicId) const;
+
+        uint16_t getTopicId(const std::string& topicName) const;
+        const std::string& getTopicName(uint16_t topicId) const;
+
+        std::unordered_map<std::string, uint16_t>::const_iterator begin() const;
+        std::unordered_map<std::string, uint16_t>::const_iterator end() const;
+
+        size_t size() const;
+        void clear();
+
+        ~TopicRegistry() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* HELPERS_TOPICREGISTRY_H_ */
@@ -0,0 +1,27 @@
+#include "MqttSNAckBitmap.h"
+#include "types/shared/Length.h"
+
+namespace mqttsn {
+
+MqttSNAckBitmap::MqttSNAckBitmap()
+{
+    MqttSNBase::addLength(Length::FOUR_OCTETS);
+}
+
+void MqttSNAckBitmap::setBitmap(uint32_t ackBitmap)
+{
+    bitmap = ackBitmap;
+}
+
+uint32_t MqttSNAckBitmap::getBitmap() const
+{
+    return bitmap;
+}
+
+uint32_t MqttSNAckBitmap::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::ACKBITMAP});
+    return allowedMsgTypes;
+}
+
+} /* namespace mqttsn */
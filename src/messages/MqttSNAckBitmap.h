@@ -0,0 +1,28 @@
+#ifndef MESSAGES_MQTTSNACKBITMAP_H_
+#define MESSAGES_MQTTSNACKBITMAP_H_
+
+#include "MqttSNBaseWithMsgId.h"
+
+namespace mqttsn {
+
+class MqttSNAckBitmap : public MqttSNBaseWithMsgId
+{
+    private:
+        // bit i acknowledges message ID msgId + 1 + i
+        uint32_t bitmap = 0;
+
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
+    public:
+        MqttSNAckBitmap();
+
+        void setBitmap(uint32_t ackBitmap);
+        uint32_t getBitmap() const;
+
+        ~MqttSNAckBitmap() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* MESSAGES_MQTTSNACKBITMAP_H_ */
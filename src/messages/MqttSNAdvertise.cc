@@ -18,4 +18,22 @@ uint8_t MqttSNAdvertise::getGwId() const
     return gwId;
 }
 
+void MqttSNAdvertise::setLoadHint(uint8_t load)
+{
+    uint32_t field = loadHint;
+    MqttSNBase::setOptionalField(load, Length::ONE_OCTET, field);
+    loadHint = field;
+}
+
+uint8_t MqttSNAdvertise::getLoadHint() const
+{
+    return loadHint;
+}
+
+uint32_t MqttSNAdvertise::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::ADVERTISE});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
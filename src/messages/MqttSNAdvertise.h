@@ -10,12 +10,21 @@ class MqttSNAdvertise : public MqttSNBaseWithDuration
     private:
         uint8_t gwId = 0;
 
+        // optional trailing octet with the gateway load; absent when zero
+        uint8_t loadHint = 0;
+
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNAdvertise();
 
         void setGwId(uint8_t gatewayId);
         uint8_t getGwId() const;
 
+        void setLoadHint(uint8_t load);
+        uint8_t getLoadHint() const;
+
         ~MqttSNAdvertise() {};
 };
 
@@ -1,24 +1,19 @@
 #include "MqttSNBase.h"
-#include "types/shared/MsgTypesMap.h"
 #include "types/shared/Length.h"
-#include "cxxabi.h"
 
 namespace mqttsn {
 
 /* Private */
 void MqttSNBase::setLength(uint16_t octets)
 {
-    if (length.size() > 0)
-        length.clear();
+    bool extended = octets > UINT8_MAX;
 
-    if (octets <= UINT8_MAX) {
-        length.push_back(static_cast<uint8_t>(octets));
-    }
-    else {
-        length.push_back(0x01);
-        length.push_back(static_cast<uint8_t>(octets & 0xFF));
-        length.push_back(static_cast<uint8_t>((octets >> 8) & 0xFF));
-   }
+    // the extended form adds two octets to the length field
+    if (extended && octets > UINT16_MAX - Length::TWO_OCTETS)
+        throw omnetpp::cRuntimeError("Message length out of range");
+
+    length = octets;
+    extendedLength = extended;
 }
 
 /* Protected */
@@ -27,7 +22,7 @@ void MqttSNBase::addLength(uint16_t octets, uint16_t prevOctets)
     if (octets == prevOctets)
         return;
 
-    uint16_t current = getLength();
+    uint16_t current = length;
 
     if (current < prevOctets)
         throw omnetpp::cRuntimeError("Previous octets cannot exceed current message length");
@@ -80,21 +75,6 @@ void MqttSNBase::setBooleanFlag(bool value, Flag position, uint8_t& flags)
     flags = (flags & ~(1 << position)) | (value << position);
 }
 
-std::string MqttSNBase::getClassName(const std::string& mangledName) const
-{
-    int status;
-    char* demangledName = abi::__cxa_demangle(mangledName.c_str(), nullptr, nullptr, &status);
-
-    if (status == 0) {
-        std::string className(demangledName);
-        free(demangledName);
-
-        return className.substr(className.find("::") + 2);
-    }
-
-    throw omnetpp::cRuntimeError("Error getting class name");
-}
-
 uint8_t MqttSNBase::getFlag(Flag position, uint8_t flags) const
 {
     return (flags >> position) & 0b11;
@@ -105,6 +85,12 @@ bool MqttSNBase::getBooleanFlag(Flag position, uint8_t flags) const
     return (flags & (1 << position)) != 0;
 }
 
+uint32_t MqttSNBase::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::WILLTOPICREQ, MsgType::WILLMSGREQ, MsgType::PINGRESP});
+    return allowedMsgTypes;
+}
+
 /* Public */
 MqttSNBase::MqttSNBase()
 {
@@ -113,15 +99,13 @@ MqttSNBase::MqttSNBase()
 
 uint16_t MqttSNBase::getLength() const
 {
-    if (length.size() == 1) {
-        return static_cast<uint16_t>(length[0]);
-    }
-
-    if (length.size() == 3 && length[0] == 0x01) {
-        return static_cast<uint16_t>(length[2]) << 8 | static_cast<uint16_t>(length[1]);
-    }
+    // length on the wire, including the extended length octets
+    return extendedLength ? length + Length::TWO_OCTETS : length;
+}
 
-    return 0;
+bool MqttSNBase::isExtendedLength() const
+{
+    return extendedLength;
 }
 
 uint16_t MqttSNBase::getAvailableLength() const
@@ -131,17 +115,13 @@ uint16_t MqttSNBase::getAvailableLength() const
 
 void MqttSNBase::setMsgType(MsgType messageType)
 {
-    std::string className = getClassName(typeid(*this).name());
-    std::vector<MsgType> types;
+    uint32_t allowedMsgTypes = getAllowedMsgTypes();
 
-    try {
-        types = msgTypesMap.at(className);
-    }
-    catch (std::out_of_range e) {
+    if (allowedMsgTypes == 0) {
         throw omnetpp::cRuntimeError("Class without message type");
     }
 
-    if (std::find(types.begin(), types.end(), messageType) == types.end()) {
+    if ((allowedMsgTypes & (1u << messageType)) == 0) {
         throw omnetpp::cRuntimeError("Incorrect message type");
     }
 
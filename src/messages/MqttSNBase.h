@@ -10,7 +10,9 @@ namespace mqttsn {
 class MqttSNBase : public inet::FieldsChunk
 {
     private:
-        std::vector<uint8_t> length;
+        // message length with a one-octet length field; the wire form uses three octets (0x01 + 2 octets) when extended
+        uint16_t length = 0;
+        bool extendedLength = false;
         MsgType msgType;
 
     private:
@@ -25,15 +27,28 @@ class MqttSNBase : public inet::FieldsChunk
         void setFlag(uint8_t value, Flag position, uint8_t& flags);
         void setBooleanFlag(bool value, Flag position, uint8_t& flags);
 
-        std::string getClassName(const std::string& mangledName) const;
-
         uint8_t getFlag(Flag position, uint8_t flags) const;
         bool getBooleanFlag(Flag position, uint8_t flags) const;
 
+        // allowed message types as a bitmask indexed by the message type value
+        static constexpr uint32_t getMsgTypesMask(std::initializer_list<MsgType> msgTypes)
+        {
+            uint32_t msgTypesMask = 0;
+
+            for (MsgType msgType : msgTypes) {
+                msgTypesMask |= 1u << msgType;
+            }
+
+            return msgTypesMask;
+        }
+
+        virtual uint32_t getAllowedMsgTypes() const;
+
     public:
         MqttSNBase();
 
         uint16_t getLength() const;
+        bool isExtendedLength() const;
         uint16_t getAvailableLength() const;
 
         void setMsgType(MsgType messageType);
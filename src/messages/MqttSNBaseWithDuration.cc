@@ -18,4 +18,10 @@ uint16_t MqttSNBaseWithDuration::getDuration() const
     return duration;
 }
 
+uint32_t MqttSNBaseWithDuration::getAllowedMsgTypes() const
+{
+    // intermediate class; no message type of its own
+    return 0;
+}
+
 } /* namespace mqttsn */
@@ -10,6 +10,9 @@ class MqttSNBaseWithDuration : public MqttSNBase
     private:
         uint16_t duration = 0;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNBaseWithDuration();
 
@@ -18,4 +18,10 @@ uint16_t MqttSNBaseWithMsgId::getMsgId() const
     return msgId;
 }
 
+uint32_t MqttSNBaseWithMsgId::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::PUBREC, MsgType::PUBREL, MsgType::PUBCOMP, MsgType::UNSUBACK});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
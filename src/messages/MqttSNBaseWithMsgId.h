@@ -10,6 +10,9 @@ class MqttSNBaseWithMsgId : public MqttSNBase
     private:
         uint16_t msgId = 0;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNBaseWithMsgId();
 
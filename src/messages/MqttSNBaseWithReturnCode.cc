@@ -18,4 +18,10 @@ ReturnCode MqttSNBaseWithReturnCode::getReturnCode() const
     return returnCode;
 }
 
+uint32_t MqttSNBaseWithReturnCode::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::CONNACK, MsgType::WILLTOPICRESP, MsgType::WILLMSGRESP});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
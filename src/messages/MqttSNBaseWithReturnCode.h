@@ -11,6 +11,9 @@ class MqttSNBaseWithReturnCode : public MqttSNBase
     private:
         ReturnCode returnCode;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNBaseWithReturnCode();
 
@@ -19,4 +19,10 @@ std::string MqttSNBaseWithWillMsg::getWillMsg() const
     return willMsg;
 }
 
+uint32_t MqttSNBaseWithWillMsg::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::WILLMSG, MsgType::WILLMSGUPD});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
@@ -10,6 +10,9 @@ class MqttSNBaseWithWillMsg : public MqttSNBase
     private:
         std::string willMsg;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNBaseWithWillMsg() {};
 
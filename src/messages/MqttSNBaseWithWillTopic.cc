@@ -44,4 +44,10 @@ std::string MqttSNBaseWithWillTopic::getWillTopic() const
     return willTopic;
 }
 
+uint32_t MqttSNBaseWithWillTopic::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::WILLTOPIC, MsgType::WILLTOPICUPD});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
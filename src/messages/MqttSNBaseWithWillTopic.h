@@ -12,6 +12,9 @@ private:
         uint8_t flags = 0;
         std::string willTopic;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNBaseWithWillTopic();
 
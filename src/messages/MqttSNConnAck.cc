@@ -0,0 +1,29 @@
+#include "MqttSNConnAck.h"
+#include "types/shared/Length.h"
+#include "types/shared/Flag.h"
+
+namespace mqttsn {
+
+void MqttSNConnAck::setAckBitmapFlag(bool ackBitmapFlag)
+{
+    uint8_t flags = extensions;
+    MqttSNBase::setBooleanFlag(ackBitmapFlag, Flag::ACK_BITMAP, flags);
+
+    // plain peers never see the octet since it is only present when set
+    uint32_t field = extensions;
+    MqttSNBase::setOptionalField(flags, Length::ONE_OCTET, field);
+    extensions = field;
+}
+
+bool MqttSNConnAck::getAckBitmapFlag() const
+{
+    return MqttSNBase::getBooleanFlag(Flag::ACK_BITMAP, extensions);
+}
+
+uint32_t MqttSNConnAck::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::CONNACK});
+    return allowedMsgTypes;
+}
+
+} /* namespace mqttsn */
@@ -0,0 +1,28 @@
+#ifndef MESSAGES_MQTTSNCONNACK_H_
+#define MESSAGES_MQTTSNCONNACK_H_
+
+#include "MqttSNBaseWithReturnCode.h"
+
+namespace mqttsn {
+
+class MqttSNConnAck : public MqttSNBaseWithReturnCode
+{
+    private:
+        // optional octet confirming the extensions requested at CONNECT
+        uint8_t extensions = 0;
+
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
+    public:
+        MqttSNConnAck() {};
+
+        void setAckBitmapFlag(bool ackBitmapFlag);
+        bool getAckBitmapFlag() const;
+
+        ~MqttSNConnAck() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* MESSAGES_MQTTSNCONNACK_H_ */
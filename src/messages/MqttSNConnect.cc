@@ -29,6 +29,16 @@ bool MqttSNConnect::getCleanSessionFlag() const
     return MqttSNBase::getBooleanFlag(Flag::CLEAN_SESSION, flags);
 }
 
+void MqttSNConnect::setAckBitmapFlag(bool ackBitmapFlag)
+{
+    MqttSNBase::setBooleanFlag(ackBitmapFlag, Flag::ACK_BITMAP, flags);
+}
+
+bool MqttSNConnect::getAckBitmapFlag() const
+{
+    return MqttSNBase::getBooleanFlag(Flag::ACK_BITMAP, flags);
+}
+
 uint8_t MqttSNConnect::getProtocolId() const
 {
     return protocolId;
@@ -50,4 +60,10 @@ std::string MqttSNConnect::getClientId() const
     return clientId;
 }
 
+uint32_t MqttSNConnect::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::CONNECT});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
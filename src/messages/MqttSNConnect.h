@@ -12,6 +12,9 @@ class MqttSNConnect : public MqttSNBaseWithDuration
         uint8_t protocolId = 0x01;
         std::string clientId;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNConnect();
 
@@ -21,6 +24,9 @@ class MqttSNConnect : public MqttSNBaseWithDuration
         void setCleanSessionFlag(bool cleanSessionFlag);
         bool getCleanSessionFlag() const;
 
+        void setAckBitmapFlag(bool ackBitmapFlag);
+        bool getAckBitmapFlag() const;
+
         uint8_t getProtocolId() const;
 
         void setClientId(const std::string& id);
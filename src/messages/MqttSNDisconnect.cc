@@ -15,4 +15,10 @@ uint16_t MqttSNDisconnect::getDuration() const
     return duration;
 }
 
+uint32_t MqttSNDisconnect::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::DISCONNECT});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
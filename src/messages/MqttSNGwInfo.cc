@@ -75,4 +75,22 @@ uint16_t MqttSNGwInfo::getGwPort() const
     return gwPort;
 }
 
+void MqttSNGwInfo::setLoadHint(uint8_t load)
+{
+    uint32_t field = loadHint;
+    MqttSNBase::setOptionalField(load, Length::ONE_OCTET, field);
+    loadHint = field;
+}
+
+uint8_t MqttSNGwInfo::getLoadHint() const
+{
+    return loadHint;
+}
+
+uint32_t MqttSNGwInfo::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::GWINFO});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
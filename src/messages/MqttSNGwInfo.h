@@ -12,6 +12,12 @@ class MqttSNGwInfo : public MqttSNBase
         uint32_t gwAdd = 0;
         uint16_t gwPort = 0;
 
+        // optional trailing octet with the gateway load; absent when zero
+        uint8_t loadHint = 0;
+
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNGwInfo();
 
@@ -24,6 +30,9 @@ class MqttSNGwInfo : public MqttSNBase
         void setGwPort(uint16_t gatewayPort);
         uint16_t getGwPort() const;
 
+        void setLoadHint(uint8_t load);
+        uint8_t getLoadHint() const;
+
         ~MqttSNGwInfo() {};
 };
 
@@ -21,4 +21,10 @@ uint16_t MqttSNMsgIdWithTopicId::getTopicId() const
     return topicId;
 }
 
+uint32_t MqttSNMsgIdWithTopicId::getAllowedMsgTypes() const
+{
+    // intermediate class; no message type of its own
+    return 0;
+}
+
 } /* namespace mqttsn */
@@ -10,6 +10,9 @@ class MqttSNMsgIdWithTopicId : public MqttSNBaseWithMsgId
     private:
         uint16_t topicId = 0;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNMsgIdWithTopicId();
 
@@ -18,4 +18,10 @@ ReturnCode MqttSNMsgIdWithTopicIdPlus::getReturnCode() const
     return returnCode;
 }
 
+uint32_t MqttSNMsgIdWithTopicIdPlus::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::REGACK, MsgType::PUBACK});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
@@ -11,6 +11,9 @@ class MqttSNMsgIdWithTopicIdPlus : public MqttSNMsgIdWithTopicId
     private:
         ReturnCode returnCode;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNMsgIdWithTopicIdPlus();
 
@@ -19,4 +19,10 @@ std::string MqttSNPingReq::getClientId() const
     return clientId;
 }
 
+uint32_t MqttSNPingReq::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::PINGREQ});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
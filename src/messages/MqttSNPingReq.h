@@ -10,6 +10,9 @@ class MqttSNPingReq : public MqttSNBase
     private:
         std::string clientId;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNPingReq() {};
 
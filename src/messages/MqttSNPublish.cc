@@ -48,20 +48,59 @@ uint8_t MqttSNPublish::getTopicIdTypeFlag() const
     return MqttSNBase::getFlag(Flag::TOPIC_ID_TYPE, flags);
 }
 
+void MqttSNPublish::setCompressionFlag(bool compressionFlag)
+{
+    MqttSNBase::setBooleanFlag(compressionFlag, Flag::COMPRESSION, flags);
+}
+
+bool MqttSNPublish::getCompressionFlag() const
+{
+    return MqttSNBase::getBooleanFlag(Flag::COMPRESSION, flags);
+}
+
+void MqttSNPublish::setDataBuffer(const PayloadBuffer& dataBuffer)
+{
+    uint16_t prevLength = data ? data->size() : 0;
+
+    // the previous data length is available again for the new value
+    if (dataBuffer->size() > MqttSNBase::getAvailableLength() + prevLength) {
+        throw omnetpp::cRuntimeError("Data string length out of range");
+    }
+
+    // share the buffer; chunk duplicates keep pointing to the same bytes
+    data = dataBuffer;
+    MqttSNBase::addLength(data->size(), prevLength);
+}
+
 void MqttSNPublish::setData(const std::string& stringData)
 {
-    MqttSNBase::setStringField(
-            stringData,
-            Length::ZERO_OCTETS,
-            MqttSNBase::getAvailableLength(),
-            "Data string length out of range",
-            data
-    );
+    setDataBuffer(std::make_shared<const std::string>(stringData));
 }
 
-std::string MqttSNPublish::getData() const
+void MqttSNPublish::setData(const PayloadBuffer& sharedData)
+{
+    if (!sharedData) {
+        throw omnetpp::cRuntimeError("Data buffer cannot be empty");
+    }
+
+    setDataBuffer(sharedData);
+}
+
+const std::string& MqttSNPublish::getData() const
+{
+    static const std::string emptyData;
+    return data ? *data : emptyData;
+}
+
+const PayloadBuffer& MqttSNPublish::getSharedData() const
 {
     return data;
 }
 
+uint32_t MqttSNPublish::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::PUBLISH});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
@@ -4,6 +4,7 @@
 #include "MqttSNMsgIdWithTopicId.h"
 #include "types/shared/QoS.h"
 #include "types/shared/TopicIdType.h"
+#include "types/shared/PayloadBuffer.h"
 
 namespace mqttsn {
 
@@ -11,7 +12,13 @@ class MqttSNPublish : public MqttSNMsgIdWithTopicId
 {
     private:
         uint8_t flags = 0;
-        std::string data;
+        PayloadBuffer data;
+
+    private:
+        void setDataBuffer(const PayloadBuffer& dataBuffer);
+
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
 
     public:
         MqttSNPublish();
@@ -28,8 +35,13 @@ class MqttSNPublish : public MqttSNMsgIdWithTopicId
         void setTopicIdTypeFlag(TopicIdType topicIdTypeFlag);
         uint8_t getTopicIdTypeFlag() const;
 
+        void setCompressionFlag(bool compressionFlag);
+        bool getCompressionFlag() const;
+
         void setData(const std::string& stringData);
-        std::string getData() const;
+        void setData(const PayloadBuffer& sharedData);
+        const std::string& getData() const;
+        const PayloadBuffer& getSharedData() const;
 
         ~MqttSNPublish() {};
 };
@@ -19,4 +19,10 @@ std::string MqttSNRegister::getTopicName() const
     return topicName;
 }
 
+uint32_t MqttSNRegister::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::REGISTER});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
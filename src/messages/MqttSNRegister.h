@@ -10,6 +10,9 @@ class MqttSNRegister : public MqttSNMsgIdWithTopicId
     private:
         std::string topicName;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNRegister() {};
 
@@ -18,4 +18,10 @@ uint8_t MqttSNSearchGw::getRadius() const
     return radius;
 }
 
+uint32_t MqttSNSearchGw::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::SEARCHGW});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
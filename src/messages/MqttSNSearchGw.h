@@ -10,6 +10,9 @@ class MqttSNSearchGw : public MqttSNBase
     private:
         uint8_t radius = 0;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNSearchGw();
 
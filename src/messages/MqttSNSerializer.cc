@@ -0,0 +1,626 @@
+#include "MqttSNSerializer.h"
+#include "inet/common/packet/serializer/ChunkSerializerRegistry.h"
+#include "MqttSNAdvertise.h"
+#include "MqttSNSearchGw.h"
+#include "MqttSNGwInfo.h"
+#include "MqttSNConnect.h"
+#include "MqttSNBaseWithReturnCode.h"
+#include "MqttSNConnAck.h"
+#include "MqttSNBaseWithWillTopic.h"
+#include "MqttSNBaseWithWillMsg.h"
+#include "MqttSNRegister.h"
+#include "MqttSNMsgIdWithTopicIdPlus.h"
+#include "MqttSNPublish.h"
+#include "MqttSNBaseWithMsgId.h"
+#include "MqttSNAckBitmap.h"
+#include "MqttSNSubscribe.h"
+#include "MqttSNSubAck.h"
+#include "MqttSNUnsubscribe.h"
+#include "MqttSNPingReq.h"
+#include "MqttSNDisconnect.h"
+#include "types/shared/Length.h"
+
+namespace mqttsn {
+
+Register_Serializer(MqttSNBase, MqttSNSerializer);
+Register_Serializer(MqttSNAdvertise, MqttSNSerializer);
+Register_Serializer(MqttSNSearchGw, MqttSNSerializer);
+Register_Serializer(MqttSNGwInfo, MqttSNSerializer);
+Register_Serializer(MqttSNBaseWithDuration, MqttSNSerializer);
+Register_Serializer(MqttSNConnect, MqttSNSerializer);
+Register_Serializer(MqttSNBaseWithReturnCode, MqttSNSerializer);
+Register_Serializer(MqttSNConnAck, MqttSNSerializer);
+Register_Serializer(MqttSNBaseWithWillTopic, MqttSNSerializer);
+Register_Serializer(MqttSNBaseWithWillMsg, MqttSNSerializer);
+Register_Serializer(MqttSNBaseWithMsgId, MqttSNSerializer);
+Register_Serializer(MqttSNAckBitmap, MqttSNSerializer);
+Register_Serializer(MqttSNMsgIdWithTopicId, MqttSNSerializer);
+Register_Serializer(MqttSNMsgIdWithTopicIdPlus, MqttSNSerializer);
+Register_Serializer(MqttSNRegister, MqttSNSerializer);
+Register_Serializer(MqttSNPublish, MqttSNSerializer);
+Register_Serializer(MqttSNUnsubscribe, MqttSNSerializer);
+Register_Serializer(MqttSNSubscribe, MqttSNSerializer);
+Register_Serializer(MqttSNSubAck, MqttSNSerializer);
+Register_Serializer(MqttSNPingReq, MqttSNSerializer);
+Register_Serializer(MqttSNDisconnect, MqttSNSerializer);
+
+/* Private */
+void MqttSNSerializer::writeString(inet::MemoryOutputStream& stream, const std::string& value)
+{
+    stream.writeBytes(reinterpret_cast<const uint8_t*>(value.data()), inet::B(value.size()));
+}
+
+std::string MqttSNSerializer::readString(inet::MemoryInputStream& stream, uint16_t octets)
+{
+    std::string value(octets, '\0');
+    stream.readBytes(reinterpret_cast<uint8_t*>(&value[0]), inet::B(octets));
+
+    return value;
+}
+
+uint8_t MqttSNSerializer::getFlags(const MqttSNBase& message)
+{
+    // rebuild the flags octet from the typed getters
+    switch (message.getMsgType()) {
+        case MsgType::CONNECT: {
+            const auto& connect = static_cast<const MqttSNConnect&>(message);
+            return (connect.getWillFlag() << Flag::WILL) | (connect.getCleanSessionFlag() << Flag::CLEAN_SESSION) |
+                   (connect.getAckBitmapFlag() << Flag::ACK_BITMAP);
+        }
+
+        case MsgType::WILLTOPIC:
+        case MsgType::WILLTOPICUPD: {
+            const auto& willTopic = static_cast<const MqttSNBaseWithWillTopic&>(message);
+            return (willTopic.getQoSFlag() << Flag::QUALITY_OF_SERVICE) | (willTopic.getRetainFlag() << Flag::RETAIN);
+        }
+
+        case MsgType::PUBLISH: {
+            const auto& publish = static_cast<const MqttSNPublish&>(message);
+            return (publish.getDupFlag() << Flag::DUP) | (publish.getQoSFlag() << Flag::QUALITY_OF_SERVICE) |
+                   (publish.getRetainFlag() << Flag::RETAIN) | (publish.getCompressionFlag() << Flag::COMPRESSION) |
+                   (publish.getTopicIdTypeFlag() << Flag::TOPIC_ID_TYPE);
+        }
+
+        case MsgType::SUBSCRIBE: {
+            const auto& subscribe = static_cast<const MqttSNSubscribe&>(message);
+            return (subscribe.getDupFlag() << Flag::DUP) | (subscribe.getQoSFlag() << Flag::QUALITY_OF_SERVICE) |
+                   (subscribe.getTopicIdTypeFlag() << Flag::TOPIC_ID_TYPE);
+        }
+
+        case MsgType::UNSUBSCRIBE:
+            return static_cast<const MqttSNUnsubscribe&>(message).getTopicIdTypeFlag() << Flag::TOPIC_ID_TYPE;
+
+        case MsgType::SUBACK: {
+            const auto& subAck = static_cast<const MqttSNSubAck&>(message);
+            return (subAck.getQoSFlag() << Flag::QUALITY_OF_SERVICE) | (subAck.getMulticastFlag() << Flag::MULTICAST);
+        }
+
+        default:
+            throw omnetpp::cRuntimeError("Message type without flags");
+    }
+}
+
+inet::Ptr<MqttSNBase> MqttSNSerializer::createMessage(MsgType msgType)
+{
+    switch (msgType) {
+        case MsgType::ADVERTISE:
+            return inet::makeShared<MqttSNAdvertise>();
+
+        case MsgType::SEARCHGW:
+            return inet::makeShared<MqttSNSearchGw>();
+
+        case MsgType::GWINFO:
+            return inet::makeShared<MqttSNGwInfo>();
+
+        case MsgType::CONNECT:
+            return inet::makeShared<MqttSNConnect>();
+
+        case MsgType::CONNACK:
+            return inet::makeShared<MqttSNConnAck>();
+
+        case MsgType::WILLTOPICRESP:
+        case MsgType::WILLMSGRESP:
+            return inet::makeShared<MqttSNBaseWithReturnCode>();
+
+        case MsgType::WILLTOPICREQ:
+        case MsgType::WILLMSGREQ:
+        case MsgType::PINGRESP:
+            return inet::makeShared<MqttSNBase>();
+
+        case MsgType::WILLTOPIC:
+        case MsgType::WILLTOPICUPD:
+            return inet::makeShared<MqttSNBaseWithWillTopic>();
+
+        case MsgType::WILLMSG:
+        case MsgType::WILLMSGUPD:
+            return inet::makeShared<MqttSNBaseWithWillMsg>();
+
+        case MsgType::REGISTER:
+            return inet::makeShared<MqttSNRegister>();
+
+        case MsgType::REGACK:
+        case MsgType::PUBACK:
+            return inet::makeShared<MqttSNMsgIdWithTopicIdPlus>();
+
+        case MsgType::PUBLISH:
+            return inet::makeShared<MqttSNPublish>();
+
+        case MsgType::PUBREC:
+        case MsgType::PUBREL:
+        case MsgType::PUBCOMP:
+        case MsgType::UNSUBACK:
+            return inet::makeShared<MqttSNBaseWithMsgId>();
+
+        case MsgType::SUBSCRIBE:
+            return inet::makeShared<MqttSNSubscribe>();
+
+        case MsgType::SUBACK:
+            return inet::makeShared<MqttSNSubAck>();
+
+        case MsgType::UNSUBSCRIBE:
+            return inet::makeShared<MqttSNUnsubscribe>();
+
+        case MsgType::PINGREQ:
+            return inet::makeShared<MqttSNPingReq>();
+
+        case MsgType::DISCONNECT:
+            return inet::makeShared<MqttSNDisconnect>();
+
+        case MsgType::ACKBITMAP:
+            return inet::makeShared<MqttSNAckBitmap>();
+
+        default:
+            return nullptr;
+    }
+}
+
+void MqttSNSerializer::serializeFields(inet::MemoryOutputStream& stream, const MqttSNBase& message)
+{
+    switch (message.getMsgType()) {
+        case MsgType::ADVERTISE: {
+            const auto& advertise = static_cast<const MqttSNAdvertise&>(message);
+            stream.writeByte(advertise.getGwId());
+            stream.writeUint16Be(advertise.getDuration());
+
+            if (advertise.getLoadHint() != 0)
+                stream.writeByte(advertise.getLoadHint());
+
+            break;
+        }
+
+        case MsgType::SEARCHGW:
+            stream.writeByte(static_cast<const MqttSNSearchGw&>(message).getRadius());
+            break;
+
+        case MsgType::GWINFO: {
+            const auto& gwInfo = static_cast<const MqttSNGwInfo&>(message);
+            stream.writeByte(gwInfo.getGwId());
+
+            // optional fields are only present when set
+            std::string gwAdd = gwInfo.getGwAdd();
+            if (!gwAdd.empty())
+                stream.writeIpv4Address(inet::Ipv4Address(gwAdd.c_str()));
+
+            if (gwInfo.getGwPort() != 0)
+                stream.writeUint16Be(gwInfo.getGwPort());
+
+            if (gwInfo.getLoadHint() != 0)
+                stream.writeByte(gwInfo.getLoadHint());
+
+            break;
+        }
+
+        case MsgType::CONNECT: {
+            const auto& connect = static_cast<const MqttSNConnect&>(message);
+            stream.writeByte(getFlags(message));
+            stream.writeByte(connect.getProtocolId());
+            stream.writeUint16Be(connect.getDuration());
+            writeString(stream, connect.getClientId());
+            break;
+        }
+
+        case MsgType::CONNACK:
+        case MsgType::WILLTOPICRESP:
+        case MsgType::WILLMSGRESP: {
+            stream.writeByte(static_cast<const MqttSNBaseWithReturnCode&>(message).getReturnCode());
+
+            // the extensions octet is only present when something was negotiated
+            const auto* connAck = dynamic_cast<const MqttSNConnAck*>(&message);
+            if (connAck != nullptr && connAck->getAckBitmapFlag())
+                stream.writeByte(1 << Flag::ACK_BITMAP);
+
+            break;
+        }
+
+        case MsgType::WILLTOPICREQ:
+        case MsgType::WILLMSGREQ:
+        case MsgType::PINGRESP:
+            break;
+
+        case MsgType::WILLTOPIC:
+        case MsgType::WILLTOPICUPD:
+            stream.writeByte(getFlags(message));
+            writeString(stream, static_cast<const MqttSNBaseWithWillTopic&>(message).getWillTopic());
+            break;
+
+        case MsgType::WILLMSG:
+        case MsgType::WILLMSGUPD:
+            writeString(stream, static_cast<const MqttSNBaseWithWillMsg&>(message).getWillMsg());
+            break;
+
+        case MsgType::REGISTER: {
+            const auto& registerMsg = static_cast<const MqttSNRegister&>(message);
+            stream.writeUint16Be(registerMsg.getTopicId());
+            stream.writeUint16Be(registerMsg.getMsgId());
+            writeString(stream, registerMsg.getTopicName());
+            break;
+        }
+
+        case MsgType::REGACK:
+        case MsgType::PUBACK:
+        case MsgType::SUBACK: {
+            const auto& ack = static_cast<const MqttSNMsgIdWithTopicIdPlus&>(message);
+
+            if (message.getMsgType() == MsgType::SUBACK)
+                stream.writeByte(getFlags(message));
+
+            stream.writeUint16Be(ack.getTopicId());
+            stream.writeUint16Be(ack.getMsgId());
+            stream.writeByte(ack.getReturnCode());
+            break;
+        }
+
+        case MsgType::PUBLISH: {
+            const auto& publish = static_cast<const MqttSNPublish&>(message);
+            stream.writeByte(getFlags(message));
+            stream.writeUint16Be(publish.getTopicId());
+            stream.writeUint16Be(publish.getMsgId());
+            writeString(stream, publish.getData());
+            break;
+        }
+
+        case MsgType::PUBREC:
+        case MsgType::PUBREL:
+        case MsgType::PUBCOMP:
+        case MsgType::UNSUBACK:
+            stream.writeUint16Be(static_cast<const MqttSNBaseWithMsgId&>(message).getMsgId());
+            break;
+
+        case MsgType::ACKBITMAP: {
+            const auto& ackBitmap = static_cast<const MqttSNAckBitmap&>(message);
+            stream.writeUint16Be(ackBitmap.getMsgId());
+            stream.writeUint32Be(ackBitmap.getBitmap());
+            break;
+        }
+
+        case MsgType::SUBSCRIBE:
+        case MsgType::UNSUBSCRIBE: {
+            const auto& unsubscribe = static_cast<const MqttSNUnsubscribe&>(message);
+            stream.writeByte(getFlags(message));
+            stream.writeUint16Be(unsubscribe.getMsgId());
+
+            // either a predefined topic ID or a (short) topic name follows
+            if (unsubscribe.getTopicIdTypeFlag() == TopicIdType::PRE_DEFINED_TOPIC_ID) {
+                if (unsubscribe.getTopicId() != 0)
+                    stream.writeUint16Be(unsubscribe.getTopicId());
+            }
+            else {
+                writeString(stream, unsubscribe.getTopicName());
+            }
+
+            break;
+        }
+
+        case MsgType::PINGREQ:
+            writeString(stream, static_cast<const MqttSNPingReq&>(message).getClientId());
+            break;
+
+        case MsgType::DISCONNECT: {
+            const auto& disconnect = static_cast<const MqttSNDisconnect&>(message);
+            if (disconnect.getDuration() != 0)
+                stream.writeUint16Be(disconnect.getDuration());
+
+            break;
+        }
+
+        default:
+            throw omnetpp::cRuntimeError("Unknown message type");
+    }
+}
+
+void MqttSNSerializer::deserializeFields(inet::MemoryInputStream& stream, MqttSNBase& message, uint16_t octets)
+{
+    // octets left after the fixed fields; a shortfall means the length field lies
+    auto getRemainingOctets = [&](uint16_t fixedOctets) -> uint16_t {
+        if (octets < fixedOctets)
+            throw omnetpp::cRuntimeError("Message shorter than its fixed fields");
+
+        return octets - fixedOctets;
+    };
+
+    switch (message.getMsgType()) {
+        case MsgType::ADVERTISE: {
+            uint16_t remainingOctets = getRemainingOctets(Length::THREE_OCTETS);
+            auto& advertise = static_cast<MqttSNAdvertise&>(message);
+            advertise.setGwId(stream.readByte());
+            advertise.setDuration(stream.readUint16Be());
+
+            if (remainingOctets > Length::ONE_OCTET)
+                throw omnetpp::cRuntimeError("Invalid advertise length");
+
+            if (remainingOctets == Length::ONE_OCTET)
+                advertise.setLoadHint(stream.readByte());
+
+            break;
+        }
+
+        case MsgType::SEARCHGW:
+            getRemainingOctets(Length::ONE_OCTET);
+            static_cast<MqttSNSearchGw&>(message).setRadius(stream.readByte());
+            break;
+
+        case MsgType::GWINFO: {
+            uint16_t remainingOctets = getRemainingOctets(Length::ONE_OCTET);
+            auto& gwInfo = static_cast<MqttSNGwInfo&>(message);
+            gwInfo.setGwId(stream.readByte());
+
+            // the only odd-sized optional field is the trailing load hint
+            bool hasLoadHint = remainingOctets % Length::TWO_OCTETS == Length::ONE_OCTET;
+            if (hasLoadHint)
+                remainingOctets -= Length::ONE_OCTET;
+
+            // the optional fields are told apart by the octets left
+            if (remainingOctets != Length::ZERO_OCTETS && remainingOctets != Length::TWO_OCTETS &&
+                remainingOctets != Length::FOUR_OCTETS && remainingOctets != Length::FOUR_OCTETS + Length::TWO_OCTETS)
+                throw omnetpp::cRuntimeError("Invalid gateway info length");
+
+            if (remainingOctets >= Length::FOUR_OCTETS)
+                gwInfo.setGwAdd(stream.readIpv4Address().str());
+
+            if (remainingOctets % Length::FOUR_OCTETS == Length::TWO_OCTETS)
+                gwInfo.setGwPort(stream.readUint16Be());
+
+            if (hasLoadHint)
+                gwInfo.setLoadHint(stream.readByte());
+
+            break;
+        }
+
+        case MsgType::CONNECT: {
+            uint16_t remainingOctets = getRemainingOctets(Length::FOUR_OCTETS);
+            auto& connect = static_cast<MqttSNConnect&>(message);
+
+            uint8_t flags = stream.readByte();
+            connect.setWillFlag((flags >> Flag::WILL) & 1);
+            connect.setCleanSessionFlag((flags >> Flag::CLEAN_SESSION) & 1);
+            connect.setAckBitmapFlag((flags >> Flag::ACK_BITMAP) & 1);
+
+            if (stream.readByte() != connect.getProtocolId())
+                throw omnetpp::cRuntimeError("Unsupported protocol ID");
+
+            connect.setDuration(stream.readUint16Be());
+            connect.setClientId(readString(stream, remainingOctets));
+            break;
+        }
+
+        case MsgType::CONNACK: {
+            uint16_t remainingOctets = getRemainingOctets(Length::ONE_OCTET);
+            auto& connAck = static_cast<MqttSNConnAck&>(message);
+            connAck.setReturnCode(static_cast<ReturnCode>(stream.readByte()));
+
+            if (remainingOctets != Length::ZERO_OCTETS && remainingOctets != Length::ONE_OCTET)
+                throw omnetpp::cRuntimeError("Invalid connection acknowledgment length");
+
+            if (remainingOctets == Length::ONE_OCTET)
+                connAck.setAckBitmapFlag((stream.readByte() >> Flag::ACK_BITMAP) & 1);
+
+            break;
+        }
+
+        case MsgType::WILLTOPICRESP:
+        case MsgType::WILLMSGRESP:
+            getRemainingOctets(Length::ONE_OCTET);
+            static_cast<MqttSNBaseWithReturnCode&>(message).setReturnCode(static_cast<ReturnCode>(stream.readByte()));
+            break;
+
+        case MsgType::WILLTOPICREQ:
+        case MsgType::WILLMSGREQ:
+        case MsgType::PINGRESP:
+            getRemainingOctets(Length::ZERO_OCTETS);
+            break;
+
+        case MsgType::WILLTOPIC:
+        case MsgType::WILLTOPICUPD: {
+            uint16_t remainingOctets = getRemainingOctets(Length::ONE_OCTET);
+            auto& willTopic = static_cast<MqttSNBaseWithWillTopic&>(message);
+
+            uint8_t flags = stream.readByte();
+            willTopic.setQoSFlag(static_cast<QoS>((flags >> Flag::QUALITY_OF_SERVICE) & 0b11));
+            willTopic.setRetainFlag((flags >> Flag::RETAIN) & 1);
+            willTopic.setWillTopic(readString(stream, remainingOctets));
+            break;
+        }
+
+        case MsgType::WILLMSG:
+        case MsgType::WILLMSGUPD:
+            static_cast<MqttSNBaseWithWillMsg&>(message).setWillMsg(readString(stream, octets));
+            break;
+
+        case MsgType::REGISTER: {
+            uint16_t remainingOctets = getRemainingOctets(Length::FOUR_OCTETS);
+            auto& registerMsg = static_cast<MqttSNRegister&>(message);
+            registerMsg.setTopicId(stream.readUint16Be());
+            registerMsg.setMsgId(stream.readUint16Be());
+            registerMsg.setTopicName(readString(stream, remainingOctets));
+            break;
+        }
+
+        case MsgType::REGACK:
+        case MsgType::PUBACK:
+        case MsgType::SUBACK: {
+            auto& ack = static_cast<MqttSNMsgIdWithTopicIdPlus&>(message);
+
+            if (message.getMsgType() == MsgType::SUBACK) {
+                getRemainingOctets(Length::FOUR_OCTETS + Length::TWO_OCTETS);
+                uint8_t flags = stream.readByte();
+                auto& subAck = static_cast<MqttSNSubAck&>(message);
+                subAck.setQoSFlag(static_cast<QoS>((flags >> Flag::QUALITY_OF_SERVICE) & 0b11));
+                subAck.setMulticastFlag((flags >> Flag::MULTICAST) & 1);
+            }
+            else {
+                getRemainingOctets(Length::FOUR_OCTETS + Length::ONE_OCTET);
+            }
+
+            ack.setTopicId(stream.readUint16Be());
+            ack.setMsgId(stream.readUint16Be());
+            ack.setReturnCode(static_cast<ReturnCode>(stream.readByte()));
+            break;
+        }
+
+        case MsgType::PUBLISH: {
+            uint16_t remainingOctets = getRemainingOctets(Length::FOUR_OCTETS + Length::ONE_OCTET);
+            auto& publish = static_cast<MqttSNPublish&>(message);
+
+            uint8_t flags = stream.readByte();
+            publish.setDupFlag((flags >> Flag::DUP) & 1);
+            publish.setQoSFlag(static_cast<QoS>((flags >> Flag::QUALITY_OF_SERVICE) & 0b11));
+            publish.setRetainFlag((flags >> Flag::RETAIN) & 1);
+            publish.setCompressionFlag((flags >> Flag::COMPRESSION) & 1);
+            publish.setTopicIdTypeFlag(static_cast<TopicIdType>((flags >> Flag::TOPIC_ID_TYPE) & 0b11));
+
+            publish.setTopicId(stream.readUint16Be());
+            publish.setMsgId(stream.readUint16Be());
+            publish.setData(readString(stream, remainingOctets));
+            break;
+        }
+
+        case MsgType::PUBREC:
+        case MsgType::PUBREL:
+        case MsgType::PUBCOMP:
+        case MsgType::UNSUBACK:
+            getRemainingOctets(Length::TWO_OCTETS);
+            static_cast<MqttSNBaseWithMsgId&>(message).setMsgId(stream.readUint16Be());
+            break;
+
+        case MsgType::ACKBITMAP: {
+            getRemainingOctets(Length::TWO_OCTETS + Length::FOUR_OCTETS);
+            auto& ackBitmap = static_cast<MqttSNAckBitmap&>(message);
+            ackBitmap.setMsgId(stream.readUint16Be());
+            ackBitmap.setBitmap(stream.readUint32Be());
+            break;
+        }
+
+        case MsgType::SUBSCRIBE:
+        case MsgType::UNSUBSCRIBE: {
+            uint16_t remainingOctets = getRemainingOctets(Length::THREE_OCTETS);
+            auto& unsubscribe = static_cast<MqttSNUnsubscribe&>(message);
+
+            uint8_t flags = stream.readByte();
+            TopicIdType topicIdType = static_cast<TopicIdType>((flags >> Flag::TOPIC_ID_TYPE) & 0b11);
+
+            if (message.getMsgType() == MsgType::SUBSCRIBE) {
+                auto& subscribe = static_cast<MqttSNSubscribe&>(message);
+                subscribe.setDupFlag((flags >> Flag::DUP) & 1);
+                subscribe.setQoSFlag(static_cast<QoS>((flags >> Flag::QUALITY_OF_SERVICE) & 0b11));
+            }
+
+            unsubscribe.setTopicIdTypeFlag(topicIdType);
+            unsubscribe.setMsgId(stream.readUint16Be());
+
+            if (topicIdType == TopicIdType::PRE_DEFINED_TOPIC_ID) {
+                if (remainingOctets != Length::ZERO_OCTETS && remainingOctets != Length::TWO_OCTETS)
+                    throw omnetpp::cRuntimeError("Invalid predefined topic ID length");
+
+                if (remainingOctets == Length::TWO_OCTETS)
+                    unsubscribe.setTopicId(stream.readUint16Be());
+            }
+            else {
+                unsubscribe.setTopicName(readString(stream, remainingOctets));
+            }
+
+            break;
+        }
+
+        case MsgType::PINGREQ:
+            if (octets != Length::ZERO_OCTETS)
+                static_cast<MqttSNPingReq&>(message).setClientId(readString(stream, octets));
+
+            break;
+
+        case MsgType::DISCONNECT:
+            if (octets != Length::ZERO_OCTETS && octets != Length::TWO_OCTETS)
+                throw omnetpp::cRuntimeError("Invalid disconnect length");
+
+            if (octets == Length::TWO_OCTETS)
+                static_cast<MqttSNDisconnect&>(message).setDuration(stream.readUint16Be());
+
+            break;
+
+        default:
+            throw omnetpp::cRuntimeError("Unknown message type");
+    }
+}
+
+/* Protected */
+void MqttSNSerializer::serialize(inet::MemoryOutputStream& stream, const inet::Ptr<const inet::Chunk>& chunk) const
+{
+    const auto& message = inet::staticPtrCast<const MqttSNBase>(chunk);
+    uint16_t length = message->getLength();
+
+    // one length octet, or 0x01 followed by two octets
+    if (message->isExtendedLength()) {
+        stream.writeByte(0x01);
+        stream.writeUint16Be(length);
+    }
+    else {
+        stream.writeByte(length);
+    }
+
+    stream.writeByte(message->getMsgType());
+    serializeFields(stream, *message);
+}
+
+const inet::Ptr<inet::Chunk> MqttSNSerializer::deserialize(inet::MemoryInputStream& stream) const
+{
+    inet::B startPosition = stream.getPosition();
+
+    uint16_t length = stream.readByte();
+    if (length == 0x01)
+        length = stream.readUint16Be();
+
+    MsgType msgType = static_cast<MsgType>(stream.readByte());
+    uint16_t headerLength = (stream.getPosition() - startPosition).get();
+
+    inet::Ptr<MqttSNBase> message = createMessage(msgType);
+
+    if (message == nullptr || stream.isReadBeyondEnd() || length < headerLength) {
+        // keep the remaining bytes inside an incorrect chunk
+        message = inet::makeShared<MqttSNBase>();
+        message->markIncorrect();
+        stream.seek(stream.getLength());
+
+        return message;
+    }
+
+    try {
+        message->setMsgType(msgType);
+        deserializeFields(stream, *message, length - headerLength);
+    }
+    catch (const omnetpp::cRuntimeError&) {
+        // field values rejected by the message setters
+        message->markIncorrect();
+    }
+
+    // the typed fields must account for every octet announced by the length field
+    if (stream.isReadBeyondEnd() || message->getLength() != length) {
+        message->markIncorrect();
+
+        // resynchronize on the announced message boundary
+        inet::b endPosition = startPosition + inet::B(length);
+        stream.seek(endPosition < stream.getLength() ? endPosition : stream.getLength());
+    }
+
+    return message;
+}
+
+} /* namespace mqttsn */
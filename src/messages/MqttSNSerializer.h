@@ -0,0 +1,31 @@
+#ifndef MESSAGES_MQTTSNSERIALIZER_H_
+#define MESSAGES_MQTTSNSERIALIZER_H_
+
+#include "inet/common/packet/serializer/FieldsChunkSerializer.h"
+#include "MqttSNBase.h"
+
+namespace mqttsn {
+
+class MqttSNSerializer : public inet::FieldsChunkSerializer
+{
+    private:
+        static void writeString(inet::MemoryOutputStream& stream, const std::string& value);
+        static std::string readString(inet::MemoryInputStream& stream, uint16_t octets);
+
+        static uint8_t getFlags(const MqttSNBase& message);
+        static inet::Ptr<MqttSNBase> createMessage(MsgType msgType);
+
+        static void serializeFields(inet::MemoryOutputStream& stream, const MqttSNBase& message);
+        static void deserializeFields(inet::MemoryInputStream& stream, MqttSNBase& message, uint16_t octets);
+
+    protected:
+        virtual void serialize(inet::MemoryOutputStream& stream, const inet::Ptr<const inet::Chunk>& chunk) const override;
+        virtual const inet::Ptr<inet::Chunk> deserialize(inet::MemoryInputStream& stream) const override;
+
+    public:
+        MqttSNSerializer() : inet::FieldsChunkSerializer() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* MESSAGES_MQTTSNSERIALIZER_H_ */
@@ -18,4 +18,20 @@ uint8_t MqttSNSubAck::getQoSFlag() const
     return MqttSNBase::getFlag(Flag::QUALITY_OF_SERVICE, flags);
 }
 
+void MqttSNSubAck::setMulticastFlag(bool multicastFlag)
+{
+    MqttSNBase::setBooleanFlag(multicastFlag, Flag::MULTICAST, flags);
+}
+
+bool MqttSNSubAck::getMulticastFlag() const
+{
+    return MqttSNBase::getBooleanFlag(Flag::MULTICAST, flags);
+}
+
+uint32_t MqttSNSubAck::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::SUBACK});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
@@ -11,12 +11,18 @@ class MqttSNSubAck : public MqttSNMsgIdWithTopicIdPlus
     private:
         uint8_t flags = 0;
 
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNSubAck();
 
         void setQoSFlag(QoS qosFlag);
         uint8_t getQoSFlag() const;
 
+        void setMulticastFlag(bool multicastFlag);
+        bool getMulticastFlag() const;
+
         ~MqttSNSubAck() {};
 };
 
@@ -22,4 +22,10 @@ uint8_t MqttSNSubscribe::getQoSFlag() const
     return MqttSNBase::getFlag(Flag::QUALITY_OF_SERVICE, flags);
 }
 
+uint32_t MqttSNSubscribe::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::SUBSCRIBE});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
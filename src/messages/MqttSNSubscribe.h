@@ -8,6 +8,9 @@ namespace mqttsn {
 
 class MqttSNSubscribe : public MqttSNUnsubscribe
 {
+    protected:
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNSubscribe() {};
 
@@ -67,4 +67,10 @@ uint16_t MqttSNUnsubscribe::getTopicId() const
     return topicId;
 }
 
+uint32_t MqttSNUnsubscribe::getAllowedMsgTypes() const
+{
+    static constexpr uint32_t allowedMsgTypes = MqttSNBase::getMsgTypesMask({MsgType::UNSUBSCRIBE});
+    return allowedMsgTypes;
+}
+
 } /* namespace mqttsn */
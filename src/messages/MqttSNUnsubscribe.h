@@ -15,6 +15,8 @@ class MqttSNUnsubscribe : public MqttSNBaseWithMsgId
     protected:
         uint8_t flags = 0;
 
+        virtual uint32_t getAllowedMsgTypes() const override;
+
     public:
         MqttSNUnsubscribe();
 
@@ -1,8 +1,9 @@
 #include "MqttSNApp.h"
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include "externals/nlohmann/json.hpp"
-#include "helpers/StringHelper.h"
 #include "types/shared/Length.h"
+#include "helpers/PacketHelper.h"
+#include "messages/MqttSNBase.h"
 #include "messages/MqttSNGwInfo.h"
 #include "messages/MqttSNPingReq.h"
 #include "messages/MqttSNDisconnect.h"
@@ -13,6 +14,9 @@ using json = nlohmann::json;
 
 unsigned MqttSNApp::serversRetransmissions = 0;
 
+double MqttSNApp::sumRetransmissionTimeouts = 0;
+unsigned MqttSNApp::retransmissionTimeouts = 0;
+
 void MqttSNApp::initialize(int stage)
 {
     ClockUserModuleMixin::initialize(stage);
@@ -21,10 +25,39 @@ void MqttSNApp::initialize(int stage)
         retransmissionInterval = par("retransmissionInterval");
         retransmissionCounter = par("retransmissionCounter");
 
+        adaptiveRetransmission = par("adaptiveRetransmission");
+        minRetransmissionInterval = par("minRetransmissionInterval");
+        maxRetransmissionInterval = par("maxRetransmissionInterval");
+        retransmissionJitter = par("retransmissionJitter");
+
+        if (minRetransmissionInterval <= 0 || minRetransmissionInterval > maxRetransmissionInterval) {
+            throw omnetpp::cRuntimeError("Invalid retransmission interval bounds");
+        }
+
+        if (retransmissionJitter < 0 || retransmissionJitter >= 1) {
+            throw omnetpp::cRuntimeError("Retransmission jitter must be in the range [0, 1)");
+        }
+
         packetBER = par("packetBER");
 
+        coalescingWindow = par("coalescingWindow");
+        coalescingMaxLength = inet::B(par("coalescingMaxLength").intValue());
+        coalescingEvent = new inet::ClockEvent("coalescingTimer");
+
+        const char* multicastAddress = par("multicastBaseAddress");
+        if (*multicastAddress) {
+            multicastBaseAddress = inet::Ipv4Address(multicastAddress);
+
+            if (!multicastBaseAddress.isMulticast()) {
+                throw omnetpp::cRuntimeError("Multicast base address '%s' is not an IPv4 multicast address", multicastAddress);
+            }
+        }
+
         serversRetransmissions = 0;
 
+        sumRetransmissionTimeouts = 0;
+        retransmissionTimeouts = 0;
+
         levelOneInit();
     }
 }
@@ -41,7 +74,22 @@ void MqttSNApp::refreshDisplay() const
 
 void MqttSNApp::socketDataArrived(inet::UdpSocket* socket, inet::Packet* packet)
 {
-    processPacket(packet);
+    // a datagram carrying a single message is processed as it is
+    if (packet->peekAtFront<MqttSNBase>()->getChunkLength() == packet->getDataLength()) {
+        processPacket(packet);
+        return;
+    }
+
+    // coalesced datagram; messages are self-delimiting, so process each one on its own
+    while (packet->getDataLength() > inet::b(0)) {
+        inet::Packet* messagePacket = new inet::Packet(packet->getName(), packet->popAtFront<MqttSNBase>());
+        messagePacket->copyTags(*packet);
+        messagePacket->setBitError(packet->hasBitError());
+
+        processPacket(messagePacket);
+    }
+
+    delete packet;
 }
 
 void MqttSNApp::socketErrorArrived(inet::UdpSocket* socket, inet::Indication* indication)
@@ -86,20 +134,73 @@ void MqttSNApp::corruptPacket(inet::Packet* packet, double ber)
     packet->setBitError(hasErrors);
 }
 
-void MqttSNApp::sendGwInfo(uint8_t gatewayId, const std::string& gatewayAddress, uint16_t gatewayPort)
+void MqttSNApp::sendPacket(inet::Packet* packet, const inet::L3Address& destAddress, int destPort)
+{
+    if (coalescingWindow <= 0) {
+        socket.sendTo(packet, destAddress, destPort);
+        return;
+    }
+
+    std::pair<inet::L3Address, int> destination(destAddress, destPort);
+    auto coalescedPacketIt = coalescedPackets.find(destination);
+
+    // keep the send order; flush the pending datagram if the message does not fit
+    if (coalescedPacketIt != coalescedPackets.end() &&
+        coalescedPacketIt->second.packet->getDataLength() + packet->getDataLength() > coalescingMaxLength) {
+        flushCoalescedPacket(coalescedPacketIt);
+    }
+
+    if (coalescedPacketIt == coalescedPackets.end()) {
+        if (packet->getDataLength() >= coalescingMaxLength) {
+            socket.sendTo(packet, destAddress, destPort);
+            return;
+        }
+
+        // hold the message for the coalescing window
+        CoalescedPacketInfo coalescedPacketInfo;
+        coalescedPacketInfo.packet = packet;
+        coalescedPacketInfo.flushTime = getClockTime() + coalescingWindow;
+
+        coalescedPackets[destination] = coalescedPacketInfo;
+
+        CoalescingDeadline coalescingDeadline;
+        coalescingDeadline.flushTime = coalescedPacketInfo.flushTime;
+        coalescingDeadline.destAddress = destAddress;
+        coalescingDeadline.destPort = destPort;
+
+        coalescingDeadlines.push_back(coalescingDeadline);
+
+        if (!coalescingEvent->isScheduled()) {
+            scheduleClockEventAt(coalescingDeadline.flushTime, coalescingEvent);
+        }
+
+        return;
+    }
+
+    // append the message to the pending datagram
+    inet::Packet* coalescedPacket = coalescedPacketIt->second.packet;
+    coalescedPacket->insertAtBack(packet->peekData());
+    coalescedPacket->setBitError(coalescedPacket->hasBitError() || packet->hasBitError());
+    coalescedPacket->setName("CoalescedPacket");
+
+    delete packet;
+}
+
+void MqttSNApp::sendGwInfo(uint8_t gatewayId, const std::string& gatewayAddress, uint16_t gatewayPort, uint8_t loadHint)
 {
     const auto& payload = inet::makeShared<MqttSNGwInfo>();
     payload->setMsgType(MsgType::GWINFO);
     payload->setGwId(gatewayId);
     payload->setGwAdd(gatewayAddress);
     payload->setGwPort(gatewayPort);
+    payload->setLoadHint(loadHint);
     payload->setChunkLength(inet::B(payload->getLength()));
 
     inet::Packet* packet = new inet::Packet("GwInfoPacket");
     packet->insertAtBack(payload);
     corruptPacket(packet, packetBER);
 
-    socket.sendTo(packet, inet::L3Address(par("broadcastAddress")), par("destPort"));
+    sendPacket(packet, inet::L3Address(par("broadcastAddress")), par("destPort"));
 }
 
 void MqttSNApp::sendPingReq(const inet::L3Address& destAddress, const int& destPort, const std::string& clientId)
@@ -117,39 +218,15 @@ void MqttSNApp::sendPingReq(const inet::L3Address& destAddress, const int& destP
     packet->insertAtBack(payload);
     corruptPacket(packet, packetBER);
 
-    socket.sendTo(packet, destAddress, destPort);
+    sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNApp::sendBase(const inet::L3Address& destAddress, const int& destPort, MsgType msgType)
 {
-    const auto& payload = inet::makeShared<MqttSNBase>();
-    payload->setMsgType(msgType);
-    payload->setChunkLength(inet::B(payload->getLength()));
-
-    std::string packetName;
-
-    switch(msgType) {
-        case MsgType::WILLTOPICREQ:
-            packetName = "WillTopicReqPacket";
-            break;
-
-        case MsgType::WILLMSGREQ:
-            packetName = "WillMsgReqPacket";
-            break;
-
-        case MsgType::PINGRESP:
-            packetName = "PingRespPacket";
-            break;
-
-        default:
-            packetName = "BasePacket";
-    }
-
-    inet::Packet* packet = new inet::Packet(packetName.c_str());
-    packet->insertAtBack(payload);
+    inet::Packet* packet = PacketHelper::getBasePacket(msgType);
     corruptPacket(packet, packetBER);
 
-    socket.sendTo(packet, destAddress, destPort);
+    sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNApp::sendDisconnect(const inet::L3Address& destAddress, const int& destPort, uint16_t duration)
@@ -167,7 +244,7 @@ void MqttSNApp::sendDisconnect(const inet::L3Address& destAddress, const int& de
     packet->insertAtBack(payload);
     corruptPacket(packet, packetBER);
 
-    socket.sendTo(packet, destAddress, destPort);
+    sendPacket(packet, destAddress, destPort);
 }
 
 bool MqttSNApp::isSelfBroadcastAddress(const inet::L3Address& address)
@@ -188,43 +265,42 @@ bool MqttSNApp::hasProbabilisticError(inet::b length, double ber)
     return rand < errorProbability;
 }
 
-bool MqttSNApp::setNextAvailableId(const std::set<uint16_t>& usedIds, uint16_t& currentId, bool allowMaxValue)
+uint16_t MqttSNApp::getNewIdentifier(IdAllocator& idAllocator, uint16_t& currentId, const std::string& error)
 {
-    // ID=0 is considered invalid; ID=UINT16_MAX can be considered invalid
-    uint16_t maxValue = allowMaxValue ? UINT16_MAX : UINT16_MAX - 1;
-
-    // if the set is full, there is no available ID
-    if (usedIds.size() >= maxValue) {
-        return false;
-    }
-
-    // if the set is empty, increment the current ID
-    if (usedIds.empty()) {
-        currentId = (currentId >= maxValue) ? 1 : currentId + 1;
-        return true;
-    }
-
-    // reset to one if the current ID is invalid (zero) or exceeds the maximum allowed value
-    if (currentId == 0 || (!allowMaxValue && currentId > maxValue)) {
-        currentId = 1;
+    if (!idAllocator.allocate(currentId)) {
+        throw omnetpp::cRuntimeError("%s", error.c_str());
     }
 
-    // find the next available ID
-    while (usedIds.find(currentId) != usedIds.end()) {
-        currentId = (currentId >= maxValue) ? 1 : currentId + 1;
-    }
+    return currentId;
+}
 
-    return true;
+void MqttSNApp::addRttSample(const inet::L3Address& destAddress, const int& destPort, double rtt)
+{
+    // samples are kept even with fixed timeouts since other policies may rely on them
+    rttEstimators[std::make_pair(destAddress, destPort)].addSample(rtt);
 }
 
-uint16_t MqttSNApp::getNewIdentifier(const std::set<uint16_t>& usedIds, uint16_t& currentId, bool allowMaxValue,
-                                     const std::string& error)
+double MqttSNApp::getRetransmissionTimeout(const inet::L3Address& destAddress, const int& destPort, int retransmissionCounter)
 {
-    if (!setNextAvailableId(usedIds, currentId, allowMaxValue)) {
-        throw omnetpp::cRuntimeError("%s", error.c_str());
+    double timeout = retransmissionInterval;
+
+    if (adaptiveRetransmission) {
+        // start from TRETRY until the first round trip with this peer is measured
+        auto it = rttEstimators.find(std::make_pair(destAddress, destPort));
+        if (it != rttEstimators.end() && it->second.hasSamples()) {
+            timeout = it->second.getTimeout();
+        }
+
+        // double the timeout for each retry and spread retries of different senders
+        timeout = std::ldexp(timeout, std::min(retransmissionCounter, 16));
+        timeout *= uniform(1 - retransmissionJitter, 1 + retransmissionJitter);
+        timeout = std::min(std::max(timeout, minRetransmissionInterval), maxRetransmissionInterval);
     }
 
-    return currentId;
+    sumRetransmissionTimeouts += timeout;
+    retransmissionTimeouts++;
+
+    return timeout;
 }
 
 bool MqttSNApp::isMinTopicLength(uint16_t topicLength)
@@ -252,34 +328,16 @@ void MqttSNApp::checkTopicLength(uint16_t topicLength, TopicIdType topicIdType)
     }
 }
 
-std::map<std::string, uint16_t> MqttSNApp::getPredefinedTopics()
+void MqttSNApp::getPredefinedTopics(TopicRegistry& topicRegistry)
 {
     json jsonData = json::parse(par("predefinedTopicsJson").stringValue());
 
-    std::set<std::string> topicNames;
-    std::set<uint16_t> topicIds;
-
-    std::map<std::string, uint16_t> result;
-
     // iterate over json array elements
     for (const auto& topic : jsonData) {
-        // extract topic name
+        // extract topic name and predefined topic ID
         std::string topicName = topic["name"];
-        std::string encodedTopicName = StringHelper::base64Encode(topicName);
-
-        // check for duplicate topic names
-        if (topicNames.find(encodedTopicName) != topicNames.end()) {
-            throw omnetpp::cRuntimeError("Duplicate topic name found: %s", topicName.c_str());
-        }
-
-        // extract predefined topic ID
         int topicId = topic["id"];
 
-        // check for duplicate topic IDs
-        if (topicIds.find(topicId) != topicIds.end()) {
-            throw omnetpp::cRuntimeError("Duplicate topic ID found: %d", topicId);
-        }
-
         // validate topic name length and type against specified criteria
         checkTopicLength(topicName.length(), TopicIdType::PRE_DEFINED_TOPIC_ID);
 
@@ -290,15 +348,87 @@ std::map<std::string, uint16_t> MqttSNApp::getPredefinedTopics()
             throw omnetpp::cRuntimeError("Invalid predefined topic ID value");
         }
 
-        // insert unique topic name and ID into respective sets
-        topicNames.insert(encodedTopicName);
-        topicIds.insert(topicId);
+        // intern the raw topic name; duplicate names or IDs are rejected by the registry
+        topicRegistry.insert(topicName, topicId);
+    }
+}
+
+void MqttSNApp::handleCoalescingEvent()
+{
+    // deadlines share the same window, so they expire in insertion order
+    while (!coalescingDeadlines.empty() && coalescingDeadlines.front().flushTime <= getClockTime()) {
+        CoalescingDeadline coalescingDeadline = coalescingDeadlines.front();
+        coalescingDeadlines.pop_front();
+
+        auto coalescedPacketIt = coalescedPackets.find(std::make_pair(coalescingDeadline.destAddress, coalescingDeadline.destPort));
+
+        // skip deadlines of datagrams already flushed by the length limit
+        if (coalescedPacketIt != coalescedPackets.end() && coalescedPacketIt->second.flushTime == coalescingDeadline.flushTime) {
+            flushCoalescedPacket(coalescedPacketIt);
+        }
+    }
+
+    if (!coalescingDeadlines.empty()) {
+        scheduleClockEventAt(coalescingDeadlines.front().flushTime, coalescingEvent);
+    }
+}
 
-        // populate the result map with the encoded topic name and ID
-        result[encodedTopicName] = topicId;
+void MqttSNApp::flushCoalescedPacket(std::map<std::pair<inet::L3Address, int>, CoalescedPacketInfo>::iterator& coalescedPacketIt)
+{
+    socket.sendTo(coalescedPacketIt->second.packet, coalescedPacketIt->first.first, coalescedPacketIt->first.second);
+    coalescedPackets.erase(coalescedPacketIt);
+
+    coalescedPacketIt = coalescedPackets.end();
+}
+
+void MqttSNApp::flushCoalescedPackets()
+{
+    cancelClockEvent(coalescingEvent);
+
+    while (!coalescedPackets.empty()) {
+        auto coalescedPacketIt = coalescedPackets.begin();
+        flushCoalescedPacket(coalescedPacketIt);
+    }
+
+    coalescingDeadlines.clear();
+}
+
+void MqttSNApp::clearCoalescedPackets()
+{
+    cancelClockEvent(coalescingEvent);
+
+    for (auto& pair : coalescedPackets) {
+        delete pair.second.packet;
+    }
+
+    coalescedPackets.clear();
+    coalescingDeadlines.clear();
+}
+
+bool MqttSNApp::isMulticastEnabled()
+{
+    return !multicastBaseAddress.isUnspecified();
+}
+
+inet::L3Address MqttSNApp::getMulticastGroup(uint8_t gatewayId, uint16_t topicId)
+{
+    // topic IDs are only unique per gateway, so each gateway owns a block of 65536 groups after the base
+    inet::Ipv4Address group(multicastBaseAddress.getInt() + ((uint32_t) gatewayId << 16) + topicId);
+
+    if (!group.isMulticast()) {
+        throw omnetpp::cRuntimeError("Multicast group of gateway %u and topic ID %u is out of the multicast range", gatewayId, topicId);
+    }
+
+    return group;
+}
+
+MqttSNApp::~MqttSNApp()
+{
+    for (auto& pair : coalescedPackets) {
+        delete pair.second.packet;
     }
 
-    return result;
+    cancelAndDelete(coalescingEvent);
 }
 
 } /* namespace mqttsn */
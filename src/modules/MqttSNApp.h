@@ -4,8 +4,15 @@
 #include "inet/applications/base/ApplicationBase.h"
 #include "inet/common/clock/ClockUserModuleMixin.h"
 #include "inet/transportlayer/contract/udp/UdpSocket.h"
+#include "inet/networklayer/contract/ipv4/Ipv4Address.h"
+#include "helpers/IdAllocator.h"
+#include "helpers/RttEstimator.h"
+#include "helpers/TopicRegistry.h"
 #include "types/shared/MsgType.h"
 #include "types/shared/TopicIdType.h"
+#include "types/shared/CoalescedPacketInfo.h"
+#include "types/shared/CoalescingDeadline.h"
+#include <deque>
 
 extern template class inet::ClockUserModuleMixin<inet::ApplicationBase>;
 
@@ -17,14 +24,32 @@ class MqttSNApp : public inet::ClockUserModuleMixin<inet::ApplicationBase>, publ
         // parameters
         double retransmissionInterval;
         int retransmissionCounter;
+        bool adaptiveRetransmission;
+        double minRetransmissionInterval;
+        double maxRetransmissionInterval;
+        double retransmissionJitter;
         double packetBER;
+        inet::Ipv4Address multicastBaseAddress;
+        double coalescingWindow;
+        inet::B coalescingMaxLength;
 
         // app state
         inet::UdpSocket socket;
 
+        // datagram coalescing
+        inet::ClockEvent* coalescingEvent = nullptr;
+        std::map<std::pair<inet::L3Address, int>, CoalescedPacketInfo> coalescedPackets;
+        std::deque<CoalescingDeadline> coalescingDeadlines;
+
+        // retransmission timeout estimation
+        std::map<std::pair<inet::L3Address, int>, RttEstimator> rttEstimators;
+
         // metrics attributes
         static unsigned serversRetransmissions;
 
+        static double sumRetransmissionTimeouts;
+        static unsigned retransmissionTimeouts;
+
     protected:
         // initialization
         virtual int numInitStages() const override { return inet::NUM_INIT_STAGES; }
@@ -43,9 +68,16 @@ class MqttSNApp : public inet::ClockUserModuleMixin<inet::ApplicationBase>, publ
         // packet handling
         virtual void checkPacketIntegrity(const inet::B& receivedLength, const inet::B& fieldLength);
         virtual void corruptPacket(inet::Packet* packet, double ber);
+        virtual void sendPacket(inet::Packet* packet, const inet::L3Address& destAddress, int destPort);
+
+        // datagram coalescing
+        virtual void handleCoalescingEvent();
+        virtual void flushCoalescedPacket(std::map<std::pair<inet::L3Address, int>, CoalescedPacketInfo>::iterator& coalescedPacketIt);
+        virtual void flushCoalescedPackets();
+        virtual void clearCoalescedPackets();
 
         // outgoing packet handling
-        virtual void sendGwInfo(uint8_t gatewayId, const std::string& gatewayAddress = "", uint16_t gatewayPort = 0);
+        virtual void sendGwInfo(uint8_t gatewayId, const std::string& gatewayAddress = "", uint16_t gatewayPort = 0, uint8_t loadHint = 0);
         virtual void sendPingReq(const inet::L3Address& destAddress, const int& destPort, const std::string& clientId = "");
         virtual void sendBase(const inet::L3Address& destAddress, const int& destPort, MsgType msgType);
         virtual void sendDisconnect(const inet::L3Address& destAddress, const int& destPort, uint16_t duration = 0);
@@ -55,15 +87,20 @@ class MqttSNApp : public inet::ClockUserModuleMixin<inet::ApplicationBase>, publ
         virtual bool hasProbabilisticError(inet::b length, double ber);
 
         // identifier methods
-        virtual bool setNextAvailableId(const std::set<uint16_t>& usedIds, uint16_t& currentId, bool allowMaxValue = true);
+        virtual uint16_t getNewIdentifier(IdAllocator& idAllocator, uint16_t& currentId, const std::string& error = "");
 
-        virtual uint16_t getNewIdentifier(const std::set<uint16_t>& usedIds, uint16_t& currentId, bool allowMaxValue = true,
-                                          const std::string& error = "");
+        // retransmission timeout methods
+        virtual void addRttSample(const inet::L3Address& destAddress, const int& destPort, double rtt);
+        virtual double getRetransmissionTimeout(const inet::L3Address& destAddress, const int& destPort, int retransmissionCounter);
 
         // topic methods
         virtual void checkTopicLength(uint16_t topicLength, TopicIdType topicIdType);
         virtual bool isMinTopicLength(uint16_t topicLength);
-        virtual std::map<std::string, uint16_t> getPredefinedTopics();
+        virtual void getPredefinedTopics(TopicRegistry& topicRegistry);
+
+        // multicast methods
+        virtual bool isMulticastEnabled();
+        virtual inet::L3Address getMulticastGroup(uint8_t gatewayId, uint16_t topicId);
 
         // pure virtual functions
         virtual void levelOneInit() = 0;
@@ -71,7 +108,7 @@ class MqttSNApp : public inet::ClockUserModuleMixin<inet::ApplicationBase>, publ
 
     public:
         MqttSNApp() {};
-        ~MqttSNApp() {};
+        ~MqttSNApp();
 };
 
 } /* namespace mqttsn */
@@ -2,13 +2,14 @@
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include "inet/networklayer/common/L3AddressTag_m.h"
 #include "inet/transportlayer/common/L4PortTag_m.h"
-#include "helpers/StringHelper.h"
 #include "types/shared/Length.h"
+#include "helpers/ConversionHelper.h"
 #include "messages/MqttSNAdvertise.h"
 #include "messages/MqttSNSearchGw.h"
 #include "messages/MqttSNGwInfo.h"
 #include "messages/MqttSNConnect.h"
 #include "messages/MqttSNBaseWithReturnCode.h"
+#include "messages/MqttSNConnAck.h"
 #include "messages/MqttSNDisconnect.h"
 #include <fstream>
 
@@ -22,6 +23,7 @@ unsigned MqttSNClient::receivedTotalPublishMsgs;
 unsigned MqttSNClient::sentUniquePublishMsgs = 0;
 unsigned MqttSNClient::receivedUniquePublishMsgs = 0;
 unsigned MqttSNClient::receivedDuplicatePublishMsgs = 0;
+unsigned MqttSNClient::receivedStalePublishMsgs = 0;
 
 unsigned MqttSNClient::publishersRetransmissions = 0;
 unsigned MqttSNClient::subscribersRetransmissions = 0;
@@ -54,7 +56,12 @@ void MqttSNClient::levelOneInit()
 
     waitingInterval = par("waitingInterval");
 
-    predefinedTopics = MqttSNApp::getPredefinedTopics();
+    gatewaySelectionPolicy = GatewaySelectionPolicy::create(
+            ConversionHelper::stringToGatewaySelectionPolicyType(par("gatewaySelectionPolicy").stringValue()),
+            par("gatewayHysteresis")
+    );
+
+    MqttSNApp::getPredefinedTopics(predefinedTopics);
 
     sumReceivedPublishMsgTimestamps = 0;
     receivedTotalPublishMsgs = 0;
@@ -62,6 +69,7 @@ void MqttSNClient::levelOneInit()
     sentUniquePublishMsgs = 0;
     receivedUniquePublishMsgs = 0;
     receivedDuplicatePublishMsgs = 0;
+    receivedStalePublishMsgs = 0;
 
     publishersRetransmissions = 0;
     subscribersRetransmissions = 0;
@@ -94,6 +102,7 @@ void MqttSNClient::handleStopOperation(inet::LifecycleOperation* operation)
     cancelActiveStateEvents();
     clearRetransmissions();
 
+    MqttSNApp::flushCoalescedPackets();
     MqttSNApp::socket.close();
 }
 
@@ -101,6 +110,7 @@ void MqttSNClient::handleCrashOperation(inet::LifecycleOperation* operation)
 {
     cancelActiveStateClockEvents();
     clearRetransmissions();
+    MqttSNApp::clearCoalescedPackets();
 
     MqttSNApp::socket.destroy();
 }
@@ -128,6 +138,9 @@ void MqttSNClient::handleMessageWhenUp(omnetpp::cMessage* msg)
     else if (msg == pingEvent) {
         handlePingEvent();
     }
+    else if (msg == MqttSNApp::coalescingEvent) {
+        MqttSNApp::handleCoalescingEvent();
+    }
     else if (!handleMessageWhenUpCustom(msg)) {
         MqttSNApp::socket.processMessage(msg);
     }
@@ -278,10 +291,12 @@ bool MqttSNClient::fromActiveToAsleep()
 
     MqttSNApp::sendDisconnect(selectedGateway.address, selectedGateway.port, sleepDuration);
 
-    // schedule disconnect retransmission
-    std::map<std::string, std::string> parameters;
-    parameters["sleepDuration"] = std::to_string(sleepDuration);
-    scheduleMsgRetransmission(selectedGateway.address, selectedGateway.port, MsgType::DISCONNECT, &parameters);
+    // schedule disconnect retransmission with the sleep duration
+    RetransmissionInfo* retransmissionInfo = scheduleMsgRetransmission(selectedGateway.address, selectedGateway.port, MsgType::DISCONNECT);
+    if (retransmissionInfo != nullptr) {
+        retransmissionInfo->hasSleepDuration = true;
+        retransmissionInfo->sleepDuration = sleepDuration;
+    }
 
     return false;
 }
@@ -318,10 +333,11 @@ bool MqttSNClient::fromAsleepToAwake()
     EV << "Asleep -> Awake" << std::endl;
     MqttSNApp::sendPingReq(selectedGateway.address, selectedGateway.port, clientId);
 
-    // schedule ping retransmission
-    std::map<std::string, std::string> parameters;
-    parameters["clientId"] = clientId;
-    scheduleMsgRetransmission(selectedGateway.address, selectedGateway.port, MsgType::PINGREQ, &parameters);
+    // schedule ping retransmission with the client ID
+    RetransmissionInfo* retransmissionInfo = scheduleMsgRetransmission(selectedGateway.address, selectedGateway.port, MsgType::PINGREQ);
+    if (retransmissionInfo != nullptr) {
+        retransmissionInfo->hasClientId = true;
+    }
 
     return true;
 }
@@ -586,7 +602,7 @@ void MqttSNClient::processAdvertise(inet::Packet* pk, const inet::L3Address& src
 {
     const auto& payload = pk->peekData<MqttSNAdvertise>();
 
-    updateActiveGateways(srcAddress, srcPort, payload->getGwId(), payload->getDuration());
+    updateActiveGateways(srcAddress, srcPort, payload->getGwId(), payload->getDuration(), payload->getLoadHint());
 }
 
 void MqttSNClient::processSearchGw()
@@ -613,11 +629,11 @@ void MqttSNClient::processGwInfo(inet::Packet* pk, const inet::L3Address& srcAdd
     if (!gatewayAddress.empty() && gatewayPort > 0) {
         // gwInfo from other client
         inet::L3Address ipAddress = inet::L3AddressResolver().resolve(gatewayAddress.c_str());
-        updateActiveGateways(ipAddress, (int) gatewayPort, gatewayId, 0);
+        updateActiveGateways(ipAddress, (int) gatewayPort, gatewayId, 0, payload->getLoadHint());
     }
     else {
         // gwInfo from a server
-        updateActiveGateways(srcAddress, srcPort, gatewayId, 0);
+        updateActiveGateways(srcAddress, srcPort, gatewayId, 0, payload->getLoadHint());
 
         // if client receives a gwInfo message, it will cancel the transmission of its gwInfo message
         cancelEvent(gatewayInfoEvent);
@@ -640,6 +656,10 @@ void MqttSNClient::processConnAck(inet::Packet* pk)
     // client is connected
     isConnected = true;
 
+    // bitmap acknowledgements only apply when the gateway confirmed them
+    const auto& connAck = inet::dynamicPtrCast<const MqttSNConnAck>(payload);
+    ackBitmap = par("ackBitmap").boolValue() && connAck != nullptr && connAck->getAckBitmapFlag();
+
     // reschedule the ping event
     cancelEvent(pingEvent);
     scheduleClockEventAfter(keepAlive, pingEvent);
@@ -664,6 +684,7 @@ void MqttSNClient::processPingResp(const inet::L3Address& srcAddress, const int&
     }
     else {
         EV << "Received ping response from server: " << srcAddress << ":" << srcPort << std::endl;
+        sampleRoundTripTime(MsgType::PINGREQ, 0);
         unscheduleMsgRetransmission(MsgType::PINGREQ);
     }
 }
@@ -715,7 +736,7 @@ void MqttSNClient::sendSearchGw()
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, inet::L3Address(par("broadcastAddress")), par("destPort"));
+    MqttSNApp::sendPacket(packet, inet::L3Address(par("broadcastAddress")), par("destPort"));
 }
 
 void MqttSNClient::sendConnect(const inet::L3Address& destAddress, const int& destPort, bool willFlag, bool cleanSessionFlag, uint16_t duration)
@@ -724,6 +745,7 @@ void MqttSNClient::sendConnect(const inet::L3Address& destAddress, const int& de
     payload->setMsgType(MsgType::CONNECT);
     payload->setWillFlag(willFlag);
     payload->setCleanSessionFlag(cleanSessionFlag);
+    payload->setAckBitmapFlag(par("ackBitmap"));
     payload->setDuration(duration);
     payload->setClientId(clientId);
     payload->setChunkLength(inet::B(payload->getLength()));
@@ -732,7 +754,7 @@ void MqttSNClient::sendConnect(const inet::L3Address& destAddress, const int& de
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNClient::handleCheckGatewaysEvent()
@@ -786,7 +808,7 @@ void MqttSNClient::handleGatewayInfoEvent()
     GatewayInfo gatewayInfo = gateway.second;
 
     // client answers with a gwInfo message
-    MqttSNApp::sendGwInfo(gatewayId, gatewayInfo.address.str(), gatewayInfo.port);
+    MqttSNApp::sendGwInfo(gatewayId, gatewayInfo.address.str(), gatewayInfo.port, gatewayInfo.loadHint);
 }
 
 void MqttSNClient::handleCheckConnectionEvent()
@@ -801,6 +823,7 @@ void MqttSNClient::handleCheckConnectionEvent()
 
         GatewayInfo gatewayInfo = gateway.second;
         selectedGateway = gatewayInfo;
+        selectedGatewayId = gateway.first;
 
         handleCheckConnectionEventCustom(gatewayInfo.address, gatewayInfo.port);
     }
@@ -818,7 +841,8 @@ void MqttSNClient::handlePingEvent()
     scheduleClockEventAfter(keepAlive, pingEvent);
 }
 
-void MqttSNClient::updateActiveGateways(const inet::L3Address& srcAddress, const int& srcPort, uint8_t gatewayId, uint16_t duration)
+void MqttSNClient::updateActiveGateways(const inet::L3Address& srcAddress, const int& srcPort, uint8_t gatewayId, uint16_t duration,
+                                        uint8_t loadHint)
 {
     auto it = gateways.find(gatewayId);
 
@@ -833,6 +857,13 @@ void MqttSNClient::updateActiveGateways(const inet::L3Address& srcAddress, const
         gatewayInfo.port = srcPort;
         gatewayInfo.duration = duration;
         gatewayInfo.lastUpdatedTime = getClockTime();
+        gatewayInfo.loadHint = loadHint;
+
+        // reuse the round-trip time measured during a previous connection
+        auto rttIt = MqttSNApp::rttEstimators.find(std::make_pair(srcAddress, srcPort));
+        if (rttIt != MqttSNApp::rttEstimators.end()) {
+            gatewayInfo.smoothedRtt = rttIt->second.getSmoothedRtt();
+        }
 
         gateways[gatewayId] = gatewayInfo;
     }
@@ -843,6 +874,7 @@ void MqttSNClient::updateActiveGateways(const inet::L3Address& srcAddress, const
         }
 
         it->second.lastUpdatedTime = getClockTime();
+        it->second.loadHint = loadHint;
     }
 }
 
@@ -864,11 +896,10 @@ std::pair<uint8_t, GatewayInfo> MqttSNClient::selectGateway()
         throw omnetpp::cRuntimeError("No active gateway found");
     }
 
-    // random selection policy
-    uint16_t index = intuniform(0, gateways.size() - 1);
-
-    auto it = gateways.begin();
-    std::advance(it, index);
+    auto it = gateways.find(gatewaySelectionPolicy->select(gateways, getRNG(0)));
+    if (it == gateways.end()) {
+        throw omnetpp::cRuntimeError("Selected gateway not found");
+    }
 
     return std::make_pair(it->first, it->second);
 }
@@ -890,33 +921,17 @@ std::string MqttSNClient::generateClientId()
 
 void MqttSNClient::scheduleRetransmissionWithMsgId(MsgType msgType, uint16_t msgId)
 {
-    // schedule retransmission with only message ID parameter
-    std::map<std::string, std::string> parameters;
-    parameters["msgId"] = std::to_string(msgId);
-    scheduleMsgRetransmission(selectedGateway.address, selectedGateway.port, msgType, &parameters);
+    scheduleMsgRetransmission(selectedGateway.address, selectedGateway.port, msgType, msgId);
 }
 
 bool MqttSNClient::checkMsgIdForType(MsgType msgType, uint16_t msgId)
 {
-    // check if the message type exists in the map and if the stored message ID matches the input one
-    auto it = retransmissions.find(msgType);
-    if (it == retransmissions.end()) {
-        // message type not found in retransmissions
+    // check if a message of this type is in flight with the input message ID
+    if (msgId == 0) {
         return false;
     }
 
-    auto retransmissionEvent = it->second.retransmissionEvent;
-    if (retransmissionEvent == nullptr) {
-        // null retransmission event
-        return false;
-    }
-
-    if (!retransmissionEvent->hasPar("msgId")) {
-        // parameter not found in retransmission event
-        return false;
-    }
-
-    return std::stoi(retransmissionEvent->par("msgId").stringValue()) == msgId;
+    return retransmissions.find(std::make_pair(msgType, msgId)) != retransmissions.end();
 }
 
 bool MqttSNClient::processAckForMsgType(MsgType msgType, uint16_t msgId)
@@ -927,29 +942,48 @@ bool MqttSNClient::processAckForMsgType(MsgType msgType, uint16_t msgId)
     }
 
     // ACK with correct message ID is received
-    unscheduleMsgRetransmission(msgType);
+    sampleRoundTripTime(msgType, msgId);
+    unscheduleMsgRetransmission(msgType, msgId);
 
     return true;
 }
 
-uint16_t MqttSNClient::getNewMsgId()
+void MqttSNClient::addRttSample(const inet::L3Address& destAddress, const int& destPort, double rtt)
 {
-    return MqttSNApp::getNewIdentifier(getUsedMsgIds(), currentMsgId,
-                                       "Failed to assign a new message ID. All available message IDs are in use");
+    MqttSNApp::addRttSample(destAddress, destPort, rtt);
+
+    double smoothedRtt = MqttSNApp::rttEstimators[std::make_pair(destAddress, destPort)].getSmoothedRtt();
+
+    // keep the gateway entry in sync for the selection policy
+    for (auto& gateway : gateways) {
+        if (gateway.second.address == destAddress && gateway.second.port == destPort) {
+            gateway.second.smoothedRtt = smoothedRtt;
+        }
+    }
 }
 
-std::set<uint16_t> MqttSNClient::getUsedMsgIds()
+void MqttSNClient::sampleRoundTripTime(MsgType msgType, uint16_t msgId)
 {
-    std::set<uint16_t> usedIds;
+    auto it = retransmissions.find(std::make_pair(msgType, msgId));
+    if (it == retransmissions.end()) {
+        return;
+    }
 
-    for (const auto& entry : retransmissions) {
-        if (entry.second.retransmissionEvent->hasPar("msgId")) {
-            // extract and insert message ID parameter value into the set
-            usedIds.insert(std::stoi(entry.second.retransmissionEvent->par("msgId").stringValue()));
-        }
+    const RetransmissionInfo& retransmissionInfo = it->second;
+
+    // Karn's rule: the ACK of a retransmitted message cannot be matched to a single send
+    if (retransmissionInfo.retransmissionCounter > 0) {
+        return;
     }
 
-    return usedIds;
+    addRttSample(retransmissionInfo.destAddress, retransmissionInfo.destPort,
+                 (getClockTime() - retransmissionInfo.sendTime).dbl());
+}
+
+uint16_t MqttSNClient::getNewMsgId()
+{
+    return MqttSNApp::getNewIdentifier(usedMsgIds, currentMsgId,
+                                       "Failed to assign a new message ID. All available message IDs are in use");
 }
 
 void MqttSNClient::checkTopicConsistency(const std::string& topicName, TopicIdType topicIdType, bool isFound)
@@ -970,13 +1004,14 @@ void MqttSNClient::checkTopicConsistency(const std::string& topicName, TopicIdTy
 
 uint16_t MqttSNClient::getPredefinedTopicId(const std::string& topicName)
 {
+    uint16_t topicId;
+
     // check if the predefined topic exists
-    auto predefinedTopicsIt = predefinedTopics.find(StringHelper::base64Encode(topicName));
-    if (predefinedTopicsIt == predefinedTopics.end()) {
+    if (!predefinedTopics.findTopicId(topicName, topicId)) {
         throw omnetpp::cRuntimeError("Predefined topic '%s' is not defined", topicName.c_str());
     }
 
-    return predefinedTopicsIt->second;
+    return topicId;
 }
 
 void MqttSNClient::handleFinalSimulationResults()
@@ -1004,6 +1039,7 @@ void MqttSNClient::printStatistics()
     std::cout << "Unique received: " << receivedUniquePublishMsgs << std::endl;
     std::cout << "Total received: " << receivedTotalPublishMsgs << std::endl;
     std::cout << "Total received duplicates: " << receivedDuplicatePublishMsgs << std::endl;
+    std::cout << "Total received out of duplicate window: " << receivedStalePublishMsgs << std::endl;
     std::cout << std::endl;
 }
 
@@ -1038,8 +1074,9 @@ void MqttSNClient::appendSimulationResultsToCsv(const std::string& filePath)
 
     // if the file does not exist, write the column headers
     if (!fileExists) {
-        outfile << "BER,Average End-to-End Delay,Hit Rate,Total Received Duplicates,"
-                   "Publishers Retransmissions,Servers Retransmissions,Subscribers Retransmissions\n";
+        outfile << "BER,Average End-to-End Delay,Hit Rate,Total Received Duplicates,Total Received Out of Window,"
+                   "Publishers Retransmissions,Servers Retransmissions,Subscribers Retransmissions,"
+                   "Adaptive Retransmission,Average Retransmission Timeout\n";
     }
 
     // calculate average end-to-end delay
@@ -1048,60 +1085,103 @@ void MqttSNClient::appendSimulationResultsToCsv(const std::string& filePath)
     // calculate hit rate
     double hitRate = sentUniquePublishMsgs > 0 ? static_cast<double>(receivedUniquePublishMsgs) / sentUniquePublishMsgs * 100 : 0;
 
+    // calculate average retransmission timeout
+    double averageTimeout = MqttSNApp::retransmissionTimeouts > 0 ?
+                            MqttSNApp::sumRetransmissionTimeouts / MqttSNApp::retransmissionTimeouts : 0;
+
     // write the simulation results to the file
-    outfile << MqttSNApp::packetBER << "," << averageDelay << "," << hitRate << "," << receivedDuplicatePublishMsgs << ","
-            << publishersRetransmissions << "," << MqttSNApp::serversRetransmissions << "," <<subscribersRetransmissions << "\n";
+    outfile << MqttSNApp::packetBER << "," << averageDelay << "," << hitRate << "," << receivedDuplicatePublishMsgs << "," << receivedStalePublishMsgs << ","
+            << publishersRetransmissions << "," << MqttSNApp::serversRetransmissions << "," <<subscribersRetransmissions << ","
+            << MqttSNApp::adaptiveRetransmission << "," << averageTimeout << "\n";
 
     // close the files
     infile.close();
     outfile.close();
 }
 
-void MqttSNClient::scheduleMsgRetransmission(const inet::L3Address& destAddress, const int& destPort, MsgType msgType,
-                                             std::map<std::string, std::string>* parameters)
+RetransmissionInfo* MqttSNClient::scheduleMsgRetransmission(const inet::L3Address& destAddress, const int& destPort, MsgType msgType,
+                                                            uint16_t msgId)
 {
-    // check if a message of the same type is already scheduled for retransmission
-    if (retransmissions.find(msgType) != retransmissions.end()) {
+    // check if the same message is already scheduled for retransmission
+    auto result = retransmissions.emplace(std::make_pair(msgType, msgId), RetransmissionInfo());
+    if (!result.second) {
         // exit without doing anything
-        return;
+        return nullptr;
     }
 
-    // create a new structure for this message type
-    RetransmissionInfo retransmissionInfo;
-    retransmissionInfo.retransmissionEvent = new inet::ClockEvent("retransmissionTimer");
+    // fill the new structure for this message
+    RetransmissionInfo& retransmissionInfo = result.first->second;
+    retransmissionInfo.retransmissionEvent = acquireRetransmissionEvent();
     retransmissionInfo.retransmissionCounter = 0;
+    retransmissionInfo.sendTime = getClockTime();
     retransmissionInfo.destAddress = destAddress;
     retransmissionInfo.destPort = destPort;
+    retransmissionInfo.msgType = msgType;
+    retransmissionInfo.msgId = msgId;
 
-    // add other dynamic parameters to the timer
-    if (parameters != nullptr) {
-        for (const auto& param : *parameters) {
-            retransmissionInfo.retransmissionEvent->addPar(param.first.c_str()).setStringValue(param.second.c_str());
-        }
+    // link the timer to its entry; map elements keep their address until erased
+    retransmissionInfo.retransmissionEvent->setContextPointer(&retransmissionInfo);
+
+    // keep the message ID in use while the message is in flight
+    if (msgId != 0) {
+        usedMsgIds.reserve(msgId);
     }
 
+    // start the timer
+    scheduleClockEventAfter(MqttSNApp::getRetransmissionTimeout(destAddress, destPort, 0), retransmissionInfo.retransmissionEvent);
+
+    return &retransmissionInfo;
+}
+
+inet::ClockEvent* MqttSNClient::acquireRetransmissionEvent()
+{
+    // reuse an idle timer if available
+    if (!retransmissionEventPool.empty()) {
+        inet::ClockEvent* retransmissionEvent = retransmissionEventPool.back();
+        retransmissionEventPool.pop_back();
+
+        return retransmissionEvent;
+    }
+
+    inet::ClockEvent* retransmissionEvent = new inet::ClockEvent("retransmissionTimer");
+
     // flag to identify this event as a retransmission message
-    retransmissionInfo.retransmissionEvent->addPar("isRetransmissionEvent");
-    // set the message type as a parameter
-    retransmissionInfo.retransmissionEvent->addPar("messageType").setLongValue(static_cast<long>(msgType));
+    retransmissionEvent->addPar("isRetransmissionEvent");
 
-    // add the timer and information to the retransmissions map
-    retransmissions[msgType] = retransmissionInfo;
+    return retransmissionEvent;
+}
 
-    // start the timer
-    scheduleClockEventAfter(MqttSNApp::retransmissionInterval, retransmissionInfo.retransmissionEvent);
+void MqttSNClient::releaseRetransmission(RetransmissionInfo& retransmissionInfo)
+{
+    // cancel the timer and keep it for later retransmissions
+    cancelEvent(retransmissionInfo.retransmissionEvent);
+    retransmissionInfo.retransmissionEvent->setContextPointer(nullptr);
+    retransmissionEventPool.push_back(retransmissionInfo.retransmissionEvent);
+
+    if (retransmissionInfo.msgId != 0) {
+        usedMsgIds.release(retransmissionInfo.msgId);
+    }
 }
 
 void MqttSNClient::unscheduleMsgRetransmission(MsgType msgType)
 {
-    // find the element in the map with the specified message type
-    auto it = retransmissions.find(msgType);
+    // remove every in-flight message of the specified type
+    auto it = retransmissions.lower_bound(std::make_pair(msgType, (uint16_t) 0));
+
+    while (it != retransmissions.end() && it->first.first == msgType) {
+        releaseRetransmission(it->second);
+        it = retransmissions.erase(it);
+    }
+}
+
+void MqttSNClient::unscheduleMsgRetransmission(MsgType msgType, uint16_t msgId)
+{
+    // find the element in the map with the specified message type and ID
+    auto it = retransmissions.find(std::make_pair(msgType, msgId));
 
     // check if the element is found in the map
     if (it != retransmissions.end()) {
-        RetransmissionInfo& retransmissionInfo = it->second;
-        // cancel the event inside the struct
-        cancelAndDelete(retransmissionInfo.retransmissionEvent);
+        releaseRetransmission(it->second);
 
         // remove the element from the map
         retransmissions.erase(it);
@@ -1113,7 +1193,7 @@ void MqttSNClient::clearRetransmissions()
     // clear the map to remove all elements
     for (auto it = retransmissions.begin(); it != retransmissions.end();) {
         // cancel all associated events in the map
-        cancelAndDelete(it->second.retransmissionEvent);
+        releaseRetransmission(it->second);
 
         // remove the element from the map
         it = retransmissions.erase(it);
@@ -1122,18 +1202,15 @@ void MqttSNClient::clearRetransmissions()
 
 void MqttSNClient::handleRetransmissionEvent(omnetpp::cMessage* msg)
 {
-    // get the message type from the message parameter
-    MsgType msgType = static_cast<MsgType>(msg->par("messageType").longValue());
-
-    auto it = retransmissions.find(msgType);
+    // get the entry linked to the timer
+    RetransmissionInfo* retransmissionInfo = static_cast<RetransmissionInfo*>(msg->getContextPointer());
 
-    // check the message type in the map
-    if (it == retransmissions.end()) {
-        // if not found, exit the function
+    if (retransmissionInfo == nullptr) {
+        // if not linked, exit the function
         return;
     }
 
-    RetransmissionInfo* retransmissionInfo = &it->second;
+    MsgType msgType = retransmissionInfo->msgType;
 
     // check if the number of retries equals the threshold
     if (retransmissionInfo->retransmissionCounter >= MqttSNApp::retransmissionCounter) {
@@ -1158,27 +1235,29 @@ void MqttSNClient::handleRetransmissionEvent(omnetpp::cMessage* msg)
 
     switch (msgType) {
         case MsgType::DISCONNECT:
-            retransmitDisconnect(retransmissionInfo->destAddress, retransmissionInfo->destPort, msg);
+            retransmitDisconnect(retransmissionInfo->destAddress, retransmissionInfo->destPort, *retransmissionInfo);
             break;
 
         case MsgType::PINGREQ:
-            retransmitPingReq(retransmissionInfo->destAddress, retransmissionInfo->destPort, msg);
+            retransmitPingReq(retransmissionInfo->destAddress, retransmissionInfo->destPort, *retransmissionInfo);
             break;
 
         default:
             break;
     }
 
-    handleRetransmissionEventCustom(retransmissionInfo->destAddress, retransmissionInfo->destPort, msg, msgType);
+    handleRetransmissionEventCustom(retransmissionInfo->destAddress, retransmissionInfo->destPort, *retransmissionInfo, msgType);
 
     retransmissionInfo->retransmissionCounter++;
-    scheduleClockEventAfter(MqttSNApp::retransmissionInterval, retransmissionInfo->retransmissionEvent);
+    scheduleClockEventAfter(MqttSNApp::getRetransmissionTimeout(retransmissionInfo->destAddress, retransmissionInfo->destPort,
+                                                                retransmissionInfo->retransmissionCounter),
+                            retransmissionInfo->retransmissionEvent);
 }
 
-void MqttSNClient::retransmitDisconnect(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg)
+void MqttSNClient::retransmitDisconnect(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo)
 {
-    if (msg->hasPar("sleepDuration")) {
-        MqttSNApp::sendDisconnect(destAddress, destPort, std::stoul(msg->par("sleepDuration").stringValue()));
+    if (retransmissionInfo.hasSleepDuration) {
+        MqttSNApp::sendDisconnect(destAddress, destPort, retransmissionInfo.sleepDuration);
     }
     else {
         MqttSNApp::sendDisconnect(destAddress, destPort);
@@ -1187,10 +1266,10 @@ void MqttSNClient::retransmitDisconnect(const inet::L3Address& destAddress, cons
     updateRetransmissionsCounter();
 }
 
-void MqttSNClient::retransmitPingReq(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg)
+void MqttSNClient::retransmitPingReq(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo)
 {
-    if (msg->hasPar("clientId")) {
-        MqttSNApp::sendPingReq(destAddress, destPort, msg->par("clientId").stringValue());
+    if (retransmissionInfo.hasClientId) {
+        MqttSNApp::sendPingReq(destAddress, destPort, clientId);
     }
     else {
         MqttSNApp::sendPingReq(destAddress, destPort);
@@ -1209,6 +1288,12 @@ MqttSNClient::~MqttSNClient()
     cancelAndDelete(pingEvent);
 
     clearRetransmissions();
+
+    delete gatewaySelectionPolicy;
+
+    for (inet::ClockEvent* retransmissionEvent : retransmissionEventPool) {
+        cancelAndDelete(retransmissionEvent);
+    }
 }
 
 } /* namespace mqttsn */
@@ -2,6 +2,7 @@
 #define MODULES_CLIENT_MQTTSNCLIENT_H_
 
 #include "../MqttSNApp.h"
+#include "helpers/GatewaySelectionPolicy.h"
 #include "types/shared/ClientState.h"
 #include "types/shared/MsgType.h"
 #include "types/client/GatewayInfo.h"
@@ -27,6 +28,7 @@ class MqttSNClient : public MqttSNApp
         double checkConnectionInterval;
         uint16_t keepAlive;
         double waitingInterval;
+        GatewaySelectionPolicy* gatewaySelectionPolicy = nullptr;
 
         // client state management
         inet::ClockEvent* stateChangeEvent = nullptr;
@@ -45,16 +47,20 @@ class MqttSNClient : public MqttSNApp
         inet::ClockEvent* checkConnectionEvent = nullptr;
         std::string clientId;
         bool isConnected = false;
+        bool ackBitmap = false;
         GatewayInfo selectedGateway;
+        uint8_t selectedGatewayId = 0;
 
         inet::ClockEvent* pingEvent = nullptr;
 
         uint16_t currentMsgId = 0;
+        IdAllocator usedMsgIds;
 
-        std::map<std::string, uint16_t> predefinedTopics;
+        TopicRegistry predefinedTopics;
 
-        // retransmission management
-        std::map<MsgType, RetransmissionInfo> retransmissions;
+        // retransmission management; messages without an ID are keyed by message ID 0
+        std::map<std::pair<MsgType, uint16_t>, RetransmissionInfo> retransmissions;
+        std::vector<inet::ClockEvent*> retransmissionEventPool;
 
         // metrics attributes
         static double sumReceivedPublishMsgTimestamps;
@@ -63,6 +69,7 @@ class MqttSNClient : public MqttSNApp
         static unsigned sentUniquePublishMsgs;
         static unsigned receivedUniquePublishMsgs;
         static unsigned receivedDuplicatePublishMsgs;
+        static unsigned receivedStalePublishMsgs;
 
         static unsigned publishersRetransmissions;
         static unsigned subscribersRetransmissions;
@@ -131,7 +138,8 @@ class MqttSNClient : public MqttSNApp
         virtual void handlePingEvent();
 
         // gateway methods
-        virtual void updateActiveGateways(const inet::L3Address& srcAddress, const int& srcPort, uint8_t gatewayId, uint16_t duration);
+        virtual void updateActiveGateways(const inet::L3Address& srcAddress, const int& srcPort, uint8_t gatewayId, uint16_t duration,
+                                          uint8_t loadHint);
         virtual bool isSelectedGateway(const inet::L3Address& srcAddress, const int& srcPort);
         virtual bool isConnectedGateway(const inet::L3Address& srcAddress, const int& srcPort);
         virtual std::pair<uint8_t, GatewayInfo> selectGateway();
@@ -143,8 +151,9 @@ class MqttSNClient : public MqttSNApp
         virtual void scheduleRetransmissionWithMsgId(MsgType msgType, uint16_t msgId);
         virtual bool checkMsgIdForType(MsgType msgType, uint16_t msgId);
         virtual bool processAckForMsgType(MsgType msgType, uint16_t msgId);
+        virtual void addRttSample(const inet::L3Address& destAddress, const int& destPort, double rtt) override;
+        virtual void sampleRoundTripTime(MsgType msgType, uint16_t msgId);
         virtual uint16_t getNewMsgId();
-        virtual std::set<uint16_t> getUsedMsgIds();
 
         // topic methods
         virtual void checkTopicConsistency(const std::string& topicName, TopicIdType topicIdType, bool isFound);
@@ -158,15 +167,18 @@ class MqttSNClient : public MqttSNApp
         virtual void appendSimulationResultsToCsv(const std::string& filePath);
 
         // retransmission management
-        virtual void scheduleMsgRetransmission(const inet::L3Address& destAddress, const int& destPort, MsgType msgType,
-                                               std::map<std::string, std::string>* parameters = nullptr);
+        virtual RetransmissionInfo* scheduleMsgRetransmission(const inet::L3Address& destAddress, const int& destPort, MsgType msgType,
+                                                              uint16_t msgId = 0);
 
+        virtual inet::ClockEvent* acquireRetransmissionEvent();
+        virtual void releaseRetransmission(RetransmissionInfo& retransmissionInfo);
         virtual void unscheduleMsgRetransmission(MsgType msgType);
+        virtual void unscheduleMsgRetransmission(MsgType msgType, uint16_t msgId);
         virtual void clearRetransmissions();
         virtual void handleRetransmissionEvent(omnetpp::cMessage* msg);
 
-        virtual void retransmitDisconnect(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg);
-        virtual void retransmitPingReq(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg);
+        virtual void retransmitDisconnect(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo);
+        virtual void retransmitPingReq(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo);
 
         // pure virtual functions
         virtual void levelTwoInit() = 0;
@@ -182,8 +194,8 @@ class MqttSNClient : public MqttSNApp
         virtual void handleCheckConnectionEventCustom(const inet::L3Address& destAddress, const int& destPort) = 0;
         virtual void populateItems() = 0;
 
-        virtual void handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg,
-                                                     MsgType msgType) = 0;
+        virtual void handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort,
+                                                     const RetransmissionInfo& retransmissionInfo, MsgType msgType) = 0;
 
         virtual void updateRetransmissionsCounter() = 0;
 
@@ -5,11 +5,14 @@
 #include "helpers/StringHelper.h"
 #include "helpers/PacketHelper.h"
 #include "helpers/NumericHelper.h"
+#include "helpers/PayloadCodec.h"
 #include "messages/MqttSNBaseWithWillTopic.h"
 #include "messages/MqttSNBaseWithWillMsg.h"
 #include "messages/MqttSNBaseWithReturnCode.h"
 #include "messages/MqttSNMsgIdWithTopicIdPlus.h"
 #include "messages/MqttSNBaseWithMsgId.h"
+#include "messages/MqttSNAckBitmap.h"
+#include <chrono>
 
 namespace mqttsn {
 
@@ -32,12 +35,53 @@ void MqttSNPublisher::levelTwoInit()
     registrationEvent = new inet::ClockEvent("registrationTimer");
 
     publishInterval = par("publishInterval");
+    publishWindow = par("publishWindow");
+    if (publishWindow <= 0) {
+        throw omnetpp::cRuntimeError("Invalid publish window: %d", publishWindow);
+    }
+
     publishEvent = new inet::ClockEvent("publishTimer");
 
+    batchMaxSamples = par("batchMaxSamples");
+    batchMaxLength = par("batchMaxLength");
+    batchMaxAge = par("batchMaxAge");
+    batchEvent = new inet::ClockEvent("batchTimer");
+
     publishMinusOneInterval = par("publishMinusOneInterval");
     publishMinusOneEvent = new inet::ClockEvent("publishMinusOneTimer");
 
+    payloadCodec = ConversionHelper::stringToPayloadCodecType(par("payloadCodec").stringValue());
+
     publishMsgIdentifier = 0;
+
+    encodedPublishMsgs = 0;
+    compressedPublishMsgs = 0;
+    rawPayloadBytes = 0;
+    sentPayloadBytes = 0;
+    encodingTime = 0;
+
+    batchedPublishMsgs = 0;
+    batchedSamples = 0;
+}
+
+void MqttSNPublisher::finish()
+{
+    if (payloadCodec != PayloadCodecType::NO_CODEC) {
+        // bytes on air saved by the codec and the host CPU time spent encoding
+        recordScalar("compressedPublishMsgs", compressedPublishMsgs);
+        recordScalar("rawPayloadBytes", rawPayloadBytes, "B");
+        recordScalar("sentPayloadBytes", sentPayloadBytes, "B");
+        recordScalar("savedPayloadBytes", rawPayloadBytes - sentPayloadBytes, "B");
+        recordScalar("meanEncodingTime", encodedPublishMsgs > 0 ? encodingTime / encodedPublishMsgs : 0, "s");
+    }
+
+    if (batchMaxSamples > 1) {
+        // publications saved by sending several samples at once
+        recordScalar("batchedPublishMsgs", batchedPublishMsgs);
+        recordScalar("meanBatchSamples", batchedPublishMsgs > 0 ? (double) batchedSamples / batchedPublishMsgs : 0);
+    }
+
+    MqttSNClient::finish();
 }
 
 bool MqttSNPublisher::handleMessageWhenUpCustom(omnetpp::cMessage* msg)
@@ -51,6 +95,9 @@ bool MqttSNPublisher::handleMessageWhenUpCustom(omnetpp::cMessage* msg)
     else if (msg == publishMinusOneEvent) {
         handlePublishMinusOneEvent();
     }
+    else if (msg == batchEvent) {
+        handleBatchEvent();
+    }
     else {
         return false;
     }
@@ -62,9 +109,15 @@ void MqttSNPublisher::scheduleActiveStateEventsCustom()
 {
     // reset last operations
     lastRegistration.retry = false;
-    lastPublish.retry = false;
     lastPublishMinusOne.retry = false;
 
+    // reset in-flight and pending publications
+    inFlightPublishes.clear();
+    retryPublishes.clear();
+
+    // samples still waiting in a batch are lost with the connection
+    publishBatches.clear();
+
     // reset registration counter
     registrationCounter = 0;
 
@@ -81,6 +134,7 @@ void MqttSNPublisher::cancelActiveStateEventsCustom()
     cancelEvent(registrationEvent);
     cancelEvent(publishEvent);
     cancelEvent(publishMinusOneEvent);
+    cancelEvent(batchEvent);
 }
 
 void MqttSNPublisher::cancelActiveStateClockEventsCustom()
@@ -88,6 +142,7 @@ void MqttSNPublisher::cancelActiveStateClockEventsCustom()
     cancelClockEvent(registrationEvent);
     cancelClockEvent(publishEvent);
     cancelClockEvent(publishMinusOneEvent);
+    cancelClockEvent(batchEvent);
 }
 
 void MqttSNPublisher::processPacketCustom(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort, MsgType msgType)
@@ -108,6 +163,7 @@ void MqttSNPublisher::processPacketCustom(inet::Packet* pk, const inet::L3Addres
         case MsgType::PUBACK:
         case MsgType::PUBREC:
         case MsgType::PUBCOMP:
+        case MsgType::ACKBITMAP:
             if (!MqttSNClient::isConnectedGateway(srcAddress, srcPort)) {
                 return;
             }
@@ -150,6 +206,10 @@ void MqttSNPublisher::processPacketCustom(inet::Packet* pk, const inet::L3Addres
             processPubComp(pk);
             break;
 
+        case MsgType::ACKBITMAP:
+            processAckBitmap(pk);
+            break;
+
         default:
             break;
     }
@@ -235,15 +295,21 @@ void MqttSNPublisher::processRegAck(inet::Packet* pk)
 void MqttSNPublisher::processPubAck(inet::Packet* pk)
 {
     const auto& payload = pk->peekData<MqttSNMsgIdWithTopicIdPlus>();
+    uint16_t msgId = payload->getMsgId();
 
-    // obtain the QoS level from the last published message
-    QoS qos = lastPublish.dataInfo->qos;
+    // a zero message ID refers to the last QoS 0 publication
+    LastPublishInfo publishInfo = lastPublish;
+
+    if (msgId != 0) {
+        auto it = inFlightPublishes.find(msgId);
 
-    if (qos == QoS::QOS_ONE || qos == QoS::QOS_TWO) {
         // check if the ACK is correct; exit if not
-        if (!MqttSNClient::processAckForMsgType(MsgType::PUBLISH, payload->getMsgId())) {
+        if (it == inFlightPublishes.end() || !MqttSNClient::processAckForMsgType(MsgType::PUBLISH, msgId)) {
             return;
         }
+
+        publishInfo = it->second;
+        inFlightPublishes.erase(it);
     }
 
     // now process and analyze message content as needed
@@ -251,8 +317,8 @@ void MqttSNPublisher::processPubAck(inet::Packet* pk)
 
     if (returnCode == ReturnCode::REJECTED_INVALID_TOPIC_ID) {
         // update registration information
-        lastRegistration.topicName = lastPublish.topicName;
-        lastRegistration.itemInfo = lastPublish.itemInfo;
+        lastRegistration.topicName = publishInfo.topicName;
+        lastRegistration.itemInfo = publishInfo.itemInfo;
         lastRegistration.retry = true;
 
         MqttSNClient::unscheduleMsgRetransmission(MsgType::REGISTER);
@@ -261,12 +327,12 @@ void MqttSNPublisher::processPubAck(inet::Packet* pk)
         // retry topic registration
         scheduleClockEventAfter(MqttSNClient::MIN_WAITING_TIME, registrationEvent);
 
-        retryLastPublish();
+        retryPublish(publishInfo);
         return;
     }
 
     if (returnCode == ReturnCode::REJECTED_CONGESTION) {
-        retryLastPublish();
+        retryPublish(publishInfo);
         return;
     }
 
@@ -275,8 +341,28 @@ void MqttSNPublisher::processPubAck(inet::Packet* pk)
     }
 
     // handle operations when publish is ACCEPTED
-    lastPublish.retry = false;
-    scheduleClockEventAfter(publishInterval, publishEvent);
+    completePublish(msgId);
+}
+
+void MqttSNPublisher::processAckBitmap(inet::Packet* pk)
+{
+    // ignore the extension if it was not negotiated with the gateway
+    if (!MqttSNClient::ackBitmap) {
+        return;
+    }
+
+    const auto& payload = pk->peekData<MqttSNAckBitmap>();
+    uint16_t msgId = payload->getMsgId();
+    uint32_t bitmap = payload->getBitmap();
+
+    // the base message ID is always acknowledged; stale or unknown IDs are skipped
+    retireAckedPublish(msgId);
+
+    for (uint16_t i = 0; bitmap != 0; i++, bitmap >>= 1) {
+        if (bitmap & 1) {
+            retireAckedPublish(msgId + 1 + i);
+        }
+    }
 }
 
 void MqttSNPublisher::processPubRec(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort)
@@ -299,15 +385,15 @@ void MqttSNPublisher::processPubRec(inet::Packet* pk, const inet::L3Address& src
 void MqttSNPublisher::processPubComp(inet::Packet* pk)
 {
     const auto& payload = pk->peekData<MqttSNBaseWithMsgId>();
+    uint16_t msgId = payload->getMsgId();
 
     // check if the ACK is correct; exit if not
-    if (!MqttSNClient::processAckForMsgType(MsgType::PUBREL, payload->getMsgId())) {
+    if (!MqttSNClient::processAckForMsgType(MsgType::PUBREL, msgId)) {
         return;
     }
 
     // proceed with the next publish
-    lastPublish.retry = false;
-    scheduleClockEventAfter(publishInterval, publishEvent);
+    completePublish(msgId);
 }
 
 void MqttSNPublisher::sendBaseWithWillTopic(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, QoS qosFlag,
@@ -339,7 +425,7 @@ void MqttSNPublisher::sendBaseWithWillTopic(const inet::L3Address& destAddress,
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNPublisher::sendBaseWithWillMsg(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, const std::string& willMsg)
@@ -368,7 +454,7 @@ void MqttSNPublisher::sendBaseWithWillMsg(const inet::L3Address& destAddress, co
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNPublisher::sendRegister(const inet::L3Address& destAddress, const int& destPort, uint16_t msgId, const std::string& topicName)
@@ -376,16 +462,74 @@ void MqttSNPublisher::sendRegister(const inet::L3Address& destAddress, const int
     inet::Packet* packet = PacketHelper::getRegisterPacket(0, msgId, topicName);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNPublisher::sendPublish(const inet::L3Address& destAddress, const int& destPort, bool dupFlag, QoS qosFlag, bool retainFlag,
-                                  TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const std::string& data, const TagInfo& tagInfo)
+                                  TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const std::string& data, const TagInfo& tagInfo,
+                                  bool compressionFlag)
 {
-    inet::Packet* packet = PacketHelper::getPublishPacket(dupFlag, qosFlag, retainFlag, topicIdTypeFlag, topicId, msgId, data, tagInfo);
+    inet::Packet* packet = PacketHelper::getPublishPacket(dupFlag, qosFlag, retainFlag, topicIdTypeFlag, topicId, msgId, data, tagInfo,
+                                                          compressionFlag);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
+}
+
+void MqttSNPublisher::sendPublish(const inet::L3Address& destAddress, const int& destPort, bool dupFlag, uint16_t msgId,
+                                  LastPublishInfo& publishInfo)
+{
+    bool batched = !publishInfo.batchData.empty();
+    const std::string& data = batched ? publishInfo.batchData : publishInfo.dataInfo->data;
+
+    // encode on the first transmission only; retransmissions and retries reuse the stored bytes
+    if (!publishInfo.encoded) {
+        publishInfo.compressed = encodePublish(data, batched, publishInfo.encodedData);
+        publishInfo.encoded = true;
+    }
+
+    sendPublish(destAddress, destPort, dupFlag, publishInfo.dataInfo->qos, publishInfo.dataInfo->retain, publishInfo.itemInfo->topicIdType,
+                publishInfo.topicId, msgId, publishInfo.compressed ? publishInfo.encodedData : data, publishInfo.tagInfo,
+                publishInfo.compressed);
+}
+
+bool MqttSNPublisher::encodePublish(const std::string& data, bool batched, std::string& encodedData)
+{
+    if (batched) {
+        auto start = std::chrono::steady_clock::now();
+        encodedData = PayloadCodec::compressBatch(payloadCodec, data);
+        encodingTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        encodedPublishMsgs++;
+        rawPayloadBytes += data.size();
+        sentPayloadBytes += encodedData.size();
+
+        // batches are always flagged, so the subscribers can split them
+        return true;
+    }
+
+    if (payloadCodec == PayloadCodecType::NO_CODEC) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool compressed = PayloadCodec::compress(payloadCodec, data, encodedData);
+    encodingTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    encodedPublishMsgs++;
+    rawPayloadBytes += data.size();
+
+    if (compressed) {
+        compressedPublishMsgs++;
+        sentPayloadBytes += encodedData.size();
+        return true;
+    }
+
+    // data the codec cannot shrink is sent as it is
+    encodedData.clear();
+    sentPayloadBytes += data.size();
+
+    return false;
 }
 
 void MqttSNPublisher::sendBaseWithMsgId(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t msgId)
@@ -393,7 +537,7 @@ void MqttSNPublisher::sendBaseWithMsgId(const inet::L3Address& destAddress, cons
     inet::Packet* packet = PacketHelper::getBaseWithMsgIdPacket(msgType, msgId);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNPublisher::handleCheckConnectionEventCustom(const inet::L3Address& destAddress, const int& destPort)
@@ -416,27 +560,35 @@ void MqttSNPublisher::handleRegistrationEvent()
 
 void MqttSNPublisher::handlePublishEvent()
 {
+    // a full window pauses publishing until a flow is completed
+    if (inFlightPublishes.size() >= (size_t) publishWindow) {
+        return;
+    }
+
+    // retried publications are sent as they are, batched or not
+    bool retry = !retryPublishes.empty();
+
     if (!proceedWithPublish()) {
         return;
     }
 
-    QoS qos = lastPublish.dataInfo->qos;
+    // retained samples keep a publication of their own
+    if (!retry && batchMaxSamples > 1 && !lastPublish.dataInfo->retain &&
+        lastPublish.dataInfo->data.size() <= PayloadCodec::MAX_SAMPLE_LENGTH) {
 
-    if (qos == QoS::QOS_ZERO) {
-        sendPublish(MqttSNClient::selectedGateway.address, MqttSNClient::selectedGateway.port, false, qos, lastPublish.dataInfo->retain,
-                    lastPublish.itemInfo->topicIdType, lastPublish.topicId, 0, lastPublish.dataInfo->data, lastPublish.tagInfo);
+        addToBatch(lastPublish);
 
-        // no need to wait for an ACK
+        // keep sampling at the publish interval
         scheduleClockEventAfter(publishInterval, publishEvent);
         return;
     }
 
-    sendPublish(MqttSNClient::selectedGateway.address, MqttSNClient::selectedGateway.port, false, qos, lastPublish.dataInfo->retain,
-                lastPublish.itemInfo->topicIdType, lastPublish.topicId, MqttSNClient::getNewMsgId(), lastPublish.dataInfo->data,
-                lastPublish.tagInfo);
+    sendPublication(lastPublish);
 
-    // schedule publish retransmission
-    MqttSNClient::scheduleRetransmissionWithMsgId(MsgType::PUBLISH, MqttSNClient::currentMsgId);
+    // no need to wait for an ACK with QoS 0; otherwise keep publishing while the window has room
+    if (lastPublish.dataInfo->qos == QoS::QOS_ZERO || inFlightPublishes.size() < (size_t) publishWindow) {
+        scheduleClockEventAfter(publishInterval, publishEvent);
+    }
 }
 
 void MqttSNPublisher::handlePublishMinusOneEvent()
@@ -445,14 +597,42 @@ void MqttSNPublisher::handlePublishMinusOneEvent()
         return;
     }
 
-    // send QoS -1 publication
+    // send QoS -1 publication; it is never retransmitted, so it is encoded on every send
+    const std::string& data = lastPublishMinusOne.dataInfo->data;
+    std::string encodedData;
+    bool compressed = encodePublish(data, false, encodedData);
+
     sendPublish(publishMinusOneDestAddress, publishMinusOneDestPort, false, QoS::QOS_MINUS_ONE, false,
-                TopicIdType::PRE_DEFINED_TOPIC_ID, lastPublishMinusOne.topicId, 0, lastPublishMinusOne.dataInfo->data,
-                lastPublishMinusOne.tagInfo);
+                TopicIdType::PRE_DEFINED_TOPIC_ID, lastPublishMinusOne.topicId, 0, compressed ? encodedData : data,
+                lastPublishMinusOne.tagInfo, compressed);
 
     scheduleClockEventAfter(publishMinusOneInterval, publishMinusOneEvent);
 }
 
+void MqttSNPublisher::handleBatchEvent()
+{
+    inet::clocktime_t currentTime = getClockTime();
+    const PublishBatchInfo* oldestBatch = nullptr;
+
+    // flush the batches whose first sample has waited long enough
+    for (auto it = publishBatches.begin(); it != publishBatches.end();) {
+        if (currentTime - it->second.creationTime >= batchMaxAge) {
+            flushBatch(it++);
+            continue;
+        }
+
+        if (oldestBatch == nullptr || it->second.creationTime < oldestBatch->creationTime) {
+            oldestBatch = &it->second;
+        }
+
+        ++it;
+    }
+
+    if (oldestBatch != nullptr) {
+        scheduleClockEventAt(oldestBatch->creationTime + batchMaxAge, batchEvent);
+    }
+}
+
 void MqttSNPublisher::validatePublishMinusOneGateway()
 {
     // check gateway address and port for QoS -1 publications
@@ -484,8 +664,8 @@ void MqttSNPublisher::populateItems()
         // validate topic name length and type against specified criteria
         MqttSNApp::checkTopicLength(topicName.length(), topicIdType);
 
-        auto predefinedTopicIt = MqttSNClient::predefinedTopics.find(StringHelper::base64Encode(topicName));
-        bool isPredefined = predefinedTopicIt != MqttSNClient::predefinedTopics.end();
+        uint16_t predefinedTopicId = 0;
+        bool isPredefined = MqttSNClient::predefinedTopics.findTopicId(topicName, predefinedTopicId);
 
         // validate topic consistency
         MqttSNClient::checkTopicConsistency(topicName, topicIdType, isPredefined);
@@ -495,7 +675,7 @@ void MqttSNPublisher::populateItems()
         itemInfo.topicIdType = topicIdType;
 
         if (isPredefined) {
-            itemInfo.topicId = predefinedTopicIt->second;
+            itemInfo.topicId = predefinedTopicId;
             itemInfo.counter = 1;
         }
 
@@ -617,19 +797,124 @@ void MqttSNPublisher::printPublishMessage(const LastPublishInfo& lastPublishInfo
     EV << "ID tag: " << lastPublishInfo.tagInfo.identifier << std::endl;
 }
 
-void MqttSNPublisher::retryLastPublish()
+void MqttSNPublisher::retryPublish(const LastPublishInfo& publishInfo)
 {
-    lastPublish.retry = true;
+    retryPublishes.push_back(publishInfo);
 
-    // reschedule the last publish
+    // reschedule the publish
     cancelEvent(publishEvent);
     scheduleClockEventAfter(MqttSNClient::waitingInterval, publishEvent);
 }
 
+void MqttSNPublisher::retireAckedPublish(uint16_t msgId)
+{
+    auto it = inFlightPublishes.find(msgId);
+
+    // only QoS 1 publications are acknowledged by bitmap
+    if (it == inFlightPublishes.end() || it->second.dataInfo->qos != QoS::QOS_ONE ||
+        !MqttSNClient::processAckForMsgType(MsgType::PUBLISH, msgId)) {
+
+        return;
+    }
+
+    completePublish(msgId);
+}
+
+void MqttSNPublisher::completePublish(uint16_t msgId)
+{
+    inFlightPublishes.erase(msgId);
+
+    // a window slot is free; proceed with the next publish
+    if (!publishEvent->isScheduled()) {
+        scheduleClockEventAfter(publishInterval, publishEvent);
+    }
+}
+
+void MqttSNPublisher::sendPublication(const LastPublishInfo& publishInfo)
+{
+    if (publishInfo.dataInfo->qos == QoS::QOS_ZERO) {
+        // a rejected QoS 0 publication is acknowledged without message ID; keep it as the last one
+        lastPublish = publishInfo;
+
+        sendPublish(MqttSNClient::selectedGateway.address, MqttSNClient::selectedGateway.port, false, 0, lastPublish);
+        return;
+    }
+
+    uint16_t msgId = MqttSNClient::getNewMsgId();
+
+    // keep the publication until its flow is completed; it also keeps the encoded bytes for retransmissions
+    LastPublishInfo& inFlightPublish = inFlightPublishes[msgId];
+    inFlightPublish = publishInfo;
+
+    sendPublish(MqttSNClient::selectedGateway.address, MqttSNClient::selectedGateway.port, false, msgId, inFlightPublish);
+
+    // schedule publish retransmission
+    MqttSNClient::scheduleRetransmissionWithMsgId(MsgType::PUBLISH, msgId);
+}
+
+void MqttSNPublisher::addToBatch(LastPublishInfo publishInfo)
+{
+    std::pair<uint16_t, QoS> key = std::make_pair(publishInfo.topicId, publishInfo.dataInfo->qos);
+    const std::string& data = publishInfo.dataInfo->data;
+
+    // flush first if the sample would not fit into the batch
+    auto batchIt = publishBatches.find(key);
+    if (batchIt != publishBatches.end() && batchIt->second.samples.size() + 1 + data.size() > (size_t) batchMaxLength) {
+        flushBatch(batchIt);
+    }
+
+    auto result = publishBatches.emplace(key, PublishBatchInfo());
+    PublishBatchInfo& batch = result.first->second;
+
+    if (result.second) {
+        batch.publishInfo = publishInfo;
+        batch.creationTime = getClockTime();
+
+        if (!batchEvent->isScheduled()) {
+            scheduleClockEventAfter(batchMaxAge, batchEvent);
+        }
+    }
+
+    PayloadCodec::appendSample(batch.samples, data);
+    batch.sampleTags.push_back(publishInfo.tagInfo);
+
+    if (batch.sampleTags.size() >= (size_t) batchMaxSamples || batch.samples.size() >= (size_t) batchMaxLength) {
+        flushBatch(result.first);
+    }
+}
+
+void MqttSNPublisher::flushBatch(std::map<std::pair<uint16_t, QoS>, PublishBatchInfo>::iterator batchIt)
+{
+    PublishBatchInfo& batch = batchIt->second;
+
+    // a lone sample is sent as an ordinary publication
+    LastPublishInfo publishInfo = batch.publishInfo;
+
+    if (batch.sampleTags.size() > 1) {
+        publishInfo.batchData = batch.samples;
+        publishInfo.tagInfo.samples = std::make_shared<const std::vector<TagInfo>>(std::move(batch.sampleTags));
+
+        batchedPublishMsgs++;
+        batchedSamples += publishInfo.tagInfo.samples->size();
+    }
+
+    publishBatches.erase(batchIt);
+
+    // with a full window the batch waits for a free slot like a rejected publication
+    if (publishInfo.dataInfo->qos != QoS::QOS_ZERO && inFlightPublishes.size() >= (size_t) publishWindow) {
+        retryPublishes.push_back(publishInfo);
+        return;
+    }
+
+    sendPublication(publishInfo);
+}
+
 bool MqttSNPublisher::proceedWithPublish()
 {
-    // if it's a retry, use the last sent element
-    if (lastPublish.retry) {
+    // if it's a retry, use the oldest rejected element
+    if (!retryPublishes.empty()) {
+        lastPublish = retryPublishes.front();
+        retryPublishes.pop_front();
         return true;
     }
 
@@ -670,7 +955,8 @@ bool MqttSNPublisher::proceedWithPublish()
         return false;
     }
 
-    // update information about the last element
+    // update information about the last element; nothing of a previous or retried publication is carried over
+    lastPublish = LastPublishInfo();
     lastPublish.topicName = topicInfo.topicName;
     lastPublish.topicId = topicIterator->first;
     lastPublish.itemInfo = topicInfo.itemInfo;
@@ -749,8 +1035,8 @@ bool MqttSNPublisher::proceedWithPublishMinusOne()
     return true;
 }
 
-void MqttSNPublisher::handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg,
-                                                      MsgType msgType)
+void MqttSNPublisher::handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort,
+                                                      const RetransmissionInfo& retransmissionInfo, MsgType msgType)
 {
     switch (msgType) {
         case MsgType::WILLTOPICUPD:
@@ -762,15 +1048,15 @@ void MqttSNPublisher::handleRetransmissionEventCustom(const inet::L3Address& des
             break;
 
         case MsgType::REGISTER:
-            retransmitRegister(destAddress, destPort, msg);
+            retransmitRegister(destAddress, destPort, retransmissionInfo);
             break;
 
         case MsgType::PUBLISH:
-            retransmitPublish(destAddress, destPort, msg);
+            retransmitPublish(destAddress, destPort, retransmissionInfo);
             break;
 
         case MsgType::PUBREL:
-            retransmitPubRel(destAddress, destPort, msg);
+            retransmitPubRel(destAddress, destPort, retransmissionInfo);
             break;
 
         default:
@@ -797,24 +1083,29 @@ void MqttSNPublisher::retransmitWillMsgUpd(const inet::L3Address& destAddress, c
     MqttSNClient::publishersRetransmissions++;
 }
 
-void MqttSNPublisher::retransmitRegister(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg)
+void MqttSNPublisher::retransmitRegister(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo)
 {
-    sendRegister(destAddress, destPort, std::stoi(msg->par("msgId").stringValue()), lastRegistration.topicName);
+    sendRegister(destAddress, destPort, retransmissionInfo.msgId, lastRegistration.topicName);
 
     MqttSNClient::publishersRetransmissions++;
 }
 
-void MqttSNPublisher::retransmitPublish(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg)
+void MqttSNPublisher::retransmitPublish(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo)
 {
-    sendPublish(destAddress, destPort, true, lastPublish.dataInfo->qos, lastPublish.dataInfo->retain, lastPublish.itemInfo->topicIdType,
-                lastPublish.topicId, std::stoi(msg->par("msgId").stringValue()), lastPublish.dataInfo->data, lastPublish.tagInfo);
+    uint16_t msgId = retransmissionInfo.msgId;
+    auto it = inFlightPublishes.find(msgId);
+    if (it == inFlightPublishes.end()) {
+        throw omnetpp::cRuntimeError("Unexpected error: In-flight publication not found");
+    }
+
+    sendPublish(destAddress, destPort, true, msgId, it->second);
 
     MqttSNClient::publishersRetransmissions++;
 }
 
-void MqttSNPublisher::retransmitPubRel(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg)
+void MqttSNPublisher::retransmitPubRel(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo)
 {
-    sendBaseWithMsgId(destAddress, destPort, MsgType::PUBREL, std::stoi(msg->par("msgId").stringValue()));
+    sendBaseWithMsgId(destAddress, destPort, MsgType::PUBREL, retransmissionInfo.msgId);
 
     MqttSNClient::publishersRetransmissions++;
 }
@@ -824,6 +1115,7 @@ MqttSNPublisher::~MqttSNPublisher()
     cancelAndDelete(registrationEvent);
     cancelAndDelete(publishEvent);
     cancelAndDelete(publishMinusOneEvent);
+    cancelAndDelete(batchEvent);
 }
 
 } /* namespace mqttsn */
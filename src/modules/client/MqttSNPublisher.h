@@ -5,11 +5,13 @@
 #include "types/shared/QoS.h"
 #include "types/shared/TopicIdType.h"
 #include "types/shared/TagInfo.h"
+#include "types/shared/PayloadCodecType.h"
 #include "types/client/publisher/DataInfo.h"
 #include "types/client/publisher/ItemInfo.h"
 #include "types/client/publisher/TopicInfo.h"
 #include "types/client/publisher/LastRegisterInfo.h"
 #include "types/client/publisher/LastPublishInfo.h"
+#include "types/client/publisher/PublishBatchInfo.h"
 
 namespace mqttsn {
 
@@ -23,9 +25,14 @@ class MqttSNPublisher : public MqttSNClient
         std::string willMsg;
         double registrationInterval;
         double publishInterval;
+        int publishWindow;
+        int batchMaxSamples;
+        int batchMaxLength;
+        double batchMaxAge;
         double publishMinusOneInterval;
         inet::L3Address publishMinusOneDestAddress;
         int publishMinusOneDestPort;
+        PayloadCodecType payloadCodec;
 
         // active publisher state
         std::map<int, ItemInfo> items;
@@ -40,6 +47,12 @@ class MqttSNPublisher : public MqttSNClient
         LastPublishInfo lastPublish;
         int publishCounter = 0;
 
+        std::map<uint16_t, LastPublishInfo> inFlightPublishes;
+        std::deque<LastPublishInfo> retryPublishes;
+
+        inet::ClockEvent* batchEvent = nullptr;
+        std::map<std::pair<uint16_t, QoS>, PublishBatchInfo> publishBatches;
+
         inet::ClockEvent* publishMinusOneEvent = nullptr;
         LastPublishInfo lastPublishMinusOne;
         int publishMinusOneCounter = 0;
@@ -47,9 +60,19 @@ class MqttSNPublisher : public MqttSNClient
         // metrics attributes
         static unsigned publishMsgIdentifier;
 
+        unsigned encodedPublishMsgs = 0;
+        unsigned compressedPublishMsgs = 0;
+        uint64_t rawPayloadBytes = 0;
+        uint64_t sentPayloadBytes = 0;
+        double encodingTime = 0;
+
+        unsigned batchedPublishMsgs = 0;
+        unsigned batchedSamples = 0;
+
     protected:
         // initialization
         virtual void levelTwoInit() override;
+        virtual void finish() override;
 
         // message handling
         virtual bool handleMessageWhenUpCustom(omnetpp::cMessage* msg) override;
@@ -70,6 +93,7 @@ class MqttSNPublisher : public MqttSNClient
         virtual void processWillResp(inet::Packet* pk, bool willTopic);
         virtual void processRegAck(inet::Packet* pk);
         virtual void processPubAck(inet::Packet* pk);
+        virtual void processAckBitmap(inet::Packet* pk);
         virtual void processPubRec(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort);
         virtual void processPubComp(inet::Packet* pk);
 
@@ -81,7 +105,13 @@ class MqttSNPublisher : public MqttSNClient
         virtual void sendRegister(const inet::L3Address& destAddress, const int& destPort, uint16_t msgId, const std::string& topicName);
 
         virtual void sendPublish(const inet::L3Address& destAddress, const int& destPort, bool dupFlag, QoS qosFlag, bool retainFlag,
-                                 TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const std::string& data, const TagInfo& tagInfo);
+                                 TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const std::string& data, const TagInfo& tagInfo,
+                                 bool compressionFlag = false);
+
+        virtual void sendPublish(const inet::L3Address& destAddress, const int& destPort, bool dupFlag, uint16_t msgId,
+                                 LastPublishInfo& publishInfo);
+
+        virtual bool encodePublish(const std::string& data, bool batched, std::string& encodedData);
 
         virtual void sendBaseWithMsgId(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t msgId);
 
@@ -90,6 +120,7 @@ class MqttSNPublisher : public MqttSNClient
         virtual void handleRegistrationEvent();
         virtual void handlePublishEvent();
         virtual void handlePublishMinusOneEvent();
+        virtual void handleBatchEvent();
 
         // gateway methods
         virtual void validatePublishMinusOneGateway();
@@ -103,21 +134,26 @@ class MqttSNPublisher : public MqttSNClient
 
         // publication methods
         virtual void printPublishMessage(const LastPublishInfo& lastPublishInfo);
-        virtual void retryLastPublish();
+        virtual void retryPublish(const LastPublishInfo& publishInfo);
+        virtual void retireAckedPublish(uint16_t msgId);
+        virtual void completePublish(uint16_t msgId);
+        virtual void sendPublication(const LastPublishInfo& publishInfo);
+        virtual void addToBatch(LastPublishInfo publishInfo);
+        virtual void flushBatch(std::map<std::pair<uint16_t, QoS>, PublishBatchInfo>::iterator batchIt);
         virtual bool proceedWithPublish();
         virtual bool proceedWithPublishMinusOne();
 
         // retransmission management
-        virtual void handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg,
-                                                     MsgType msgType) override;
+        virtual void handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort,
+                                                     const RetransmissionInfo& retransmissionInfo, MsgType msgType) override;
 
         virtual void updateRetransmissionsCounter() override;
 
         virtual void retransmitWillTopicUpd(const inet::L3Address& destAddress, const int& destPort);
         virtual void retransmitWillMsgUpd(const inet::L3Address& destAddress, const int& destPort);
-        virtual void retransmitRegister(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg);
-        virtual void retransmitPublish(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg);
-        virtual void retransmitPubRel(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg);
+        virtual void retransmitRegister(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo);
+        virtual void retransmitPublish(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo);
+        virtual void retransmitPubRel(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo);
 
     public:
         MqttSNPublisher() {};
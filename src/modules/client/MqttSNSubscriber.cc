@@ -1,7 +1,6 @@
 #include "MqttSNSubscriber.h"
 #include "externals/nlohmann/json.hpp"
-#include "inet/common/TimeTag_m.h"
-#include "tags/IdentifierTag.h"
+#include "inet/networklayer/common/L3AddressTag_m.h"
 #include "helpers/ConversionHelper.h"
 #include "helpers/StringHelper.h"
 #include "helpers/NumericHelper.h"
@@ -10,8 +9,11 @@
 #include "messages/MqttSNSubAck.h"
 #include "messages/MqttSNUnsubscribe.h"
 #include "messages/MqttSNBaseWithMsgId.h"
+#include "messages/MqttSNAckBitmap.h"
 #include "messages/MqttSNRegister.h"
 #include "messages/MqttSNPublish.h"
+#include "helpers/PayloadCodec.h"
+#include <chrono>
 
 namespace mqttsn {
 
@@ -19,7 +21,8 @@ Define_Module(MqttSNSubscriber);
 
 using json = nlohmann::json;
 
-std::set<unsigned> MqttSNSubscriber::publishMsgIdentifiers;
+DuplicateDetector MqttSNSubscriber::deliveryDetector;
+int MqttSNSubscriber::deliveryWindow = 0;
 
 void MqttSNSubscriber::levelTwoInit()
 {
@@ -31,8 +34,42 @@ void MqttSNSubscriber::levelTwoInit()
     unsubscriptionInterval = par("unsubscriptionInterval");
     unsubscriptionEvent = new inet::ClockEvent("unsubscriptionTimer");
 
-    instancePublishMsgIdentifiers.clear();
-    publishMsgIdentifiers.clear();
+    ackBitmapWindow = par("ackBitmapWindow");
+    ackBitmapEvent = new inet::ClockEvent("ackBitmapTimer");
+
+    int duplicateWindow = par("duplicateWindow");
+    if (duplicateWindow <= 0) {
+        throw omnetpp::cRuntimeError("Invalid duplicate detection window: %d", duplicateWindow);
+    }
+
+    instanceDuplicateDetector = DuplicateDetector(duplicateWindow);
+
+    // the first subscriber sizes the window shared by all of them
+    if (deliveryWindow == 0) {
+        deliveryWindow = duplicateWindow;
+        deliveryDetector = DuplicateDetector(duplicateWindow);
+    }
+    else if (deliveryWindow != duplicateWindow) {
+        throw omnetpp::cRuntimeError("Duplicate detection window differs between subscribers: %d and %d", deliveryWindow,
+                                     duplicateWindow);
+    }
+
+    decompressedPublishMsgs = 0;
+    decodingTime = 0;
+}
+
+void MqttSNSubscriber::finish()
+{
+    if (decompressedPublishMsgs > 0) {
+        // host CPU time spent decoding compressed publication data
+        recordScalar("decompressedPublishMsgs", decompressedPublishMsgs);
+        recordScalar("meanDecodingTime", decodingTime / decompressedPublishMsgs, "s");
+    }
+
+    // let the next run size the shared window again
+    deliveryWindow = 0;
+
+    MqttSNClient::finish();
 }
 
 bool MqttSNSubscriber::handleMessageWhenUpCustom(omnetpp::cMessage* msg)
@@ -43,6 +80,9 @@ bool MqttSNSubscriber::handleMessageWhenUpCustom(omnetpp::cMessage* msg)
     else if (msg == unsubscriptionEvent) {
         handleUnsubscriptionEvent();
     }
+    else if (msg == ackBitmapEvent) {
+        handleAckBitmapEvent();
+    }
     else {
         return false;
     }
@@ -71,12 +111,19 @@ void MqttSNSubscriber::cancelActiveStateEventsCustom()
 {
     cancelEvent(subscriptionEvent);
     cancelEvent(unsubscriptionEvent);
+
+    // acknowledge what was already delivered before leaving the active state
+    flushAckBitmap();
 }
 
 void MqttSNSubscriber::cancelActiveStateClockEventsCustom()
 {
     cancelClockEvent(subscriptionEvent);
     cancelClockEvent(unsubscriptionEvent);
+
+    // drop the pending batch; the gateway retransmits the unacknowledged messages
+    cancelClockEvent(ackBitmapEvent);
+    ackBitmapAccumulator.reset();
 }
 
 void MqttSNSubscriber::adjustAllowedPacketTypes(std::vector<MsgType>& msgTypes)
@@ -170,6 +217,11 @@ void MqttSNSubscriber::processSubAck(inet::Packet* pk, const inet::L3Address& sr
     topicInfo.topicName = lastSubscription.topicName;
     topicInfo.itemInfo = lastSubscription.itemInfo;
 
+    // only topics delivered via multicast are worth a group membership
+    if (payload->getMulticastFlag()) {
+        joinMulticastTopic(topicId);
+    }
+
     NumericHelper::incrementCounter(&(lastSubscription.itemInfo->subscribeCounter));
 
     lastSubscription.retry = false;
@@ -192,6 +244,8 @@ void MqttSNSubscriber::processUnsubAck(inet::Packet* pk, const inet::L3Address&
     auto& itemInfo = lastUnsubscription.itemInfo;
     TopicIdType topicIdType = itemInfo->topicIdType;
 
+    leaveMulticastTopic(lastUnsubscription.topicName);
+
     // enable re-subscription for predefined/short topics
     if (topicIdType == TopicIdType::PRE_DEFINED_TOPIC_ID || topicIdType == TopicIdType::SHORT_TOPIC_ID) {
         itemInfo->subscribeCounter = 0;
@@ -260,9 +314,24 @@ void MqttSNSubscriber::processPublish(inet::Packet* pk, const inet::L3Address& s
     TopicIdType topicIdType = (TopicIdType) payload->getTopicIdTypeFlag();
     uint16_t msgId = payload->getMsgId();
 
+    // accept multicast copies only from the connected gateway and on the group joined for this topic
+    const inet::L3Address& destAddress = pk->getTag<inet::L3AddressInd>()->getDestAddress();
+    if (destAddress.isMulticast()) {
+        auto groupIt = multicastGroups.find(topicId);
+        if (!MqttSNClient::isConnectedGateway(srcAddress, srcPort) || groupIt == multicastGroups.end() ||
+            groupIt->second != destAddress) {
+            return;
+        }
+    }
+
     // verify topic ID existence and type consistency
     auto it = topics.find(topicId);
     if (it == topics.end() || it->second.itemInfo->topicIdType != topicIdType) {
+        // a multicast copy may reach a subscriber still waiting for the topic registration
+        if (destAddress.isMulticast()) {
+            return;
+        }
+
         sendMsgIdWithTopicIdPlus(srcAddress, srcPort, MsgType::PUBACK, topicId, msgId, ReturnCode::REJECTED_INVALID_TOPIC_ID);
         return;
     }
@@ -270,10 +339,31 @@ void MqttSNSubscriber::processPublish(inet::Packet* pk, const inet::L3Address& s
     QoS qos = (QoS) payload->getQoSFlag();
     bool retain = payload->getRetainFlag();
     std::string data = payload->getData();
+    std::vector<std::string> samples;
+
+    if (payload->getCompressionFlag()) {
+        auto start = std::chrono::steady_clock::now();
+
+        try {
+            bool batched = PayloadCodec::isBatch(data);
+            data = PayloadCodec::decompress(data);
+
+            // a batched publication is split back into its samples
+            if (batched) {
+                samples = PayloadCodec::unpackSamples(data);
+            }
+        }
+        catch (const omnetpp::cRuntimeError& error) {
+            // undecodable data is dropped without acknowledgment
+            EV_WARN << "Discarded publish message: " << error.what() << std::endl;
+            return;
+        }
+
+        decodingTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        decompressedPublishMsgs++;
+    }
 
-    TagInfo tagInfo;
-    tagInfo.timestamp = inet::ClockTime::SIMTIME_AS_CLOCKTIME(payload->findTag<inet::CreationTimeTag>()->getCreationTime());
-    tagInfo.identifier = payload->findTag<IdentifierTag>()->getIdentifier();
+    TagInfo tagInfo = PacketHelper::getTagInfo(payload);
 
     MessageInfo messageInfo;
     messageInfo.topicName = topics[topicId].topicName;
@@ -283,19 +373,25 @@ void MqttSNSubscriber::processPublish(inet::Packet* pk, const inet::L3Address& s
     messageInfo.qos = qos;
     messageInfo.retain = retain;
     messageInfo.data = data;
+    messageInfo.samples = samples;
     messageInfo.tagInfo = tagInfo;
 
     if (qos == QoS::QOS_MINUS_ONE || qos == QoS::QOS_ZERO) {
         // handling QoS -1 or QoS 0
-        printPublishMessage(messageInfo);
-        handlePublishMessageMetrics(tagInfo);
+        deliverPublishMessage(messageInfo);
         return;
     }
 
     if (qos == QoS::QOS_ONE) {
         // handling QoS 1
-        printPublishMessage(messageInfo);
-        handlePublishMessageMetrics(tagInfo);
+        deliverPublishMessage(messageInfo);
+
+        // batch the acknowledgement when negotiated with the gateway
+        if (MqttSNClient::ackBitmap && msgId > 0) {
+            addPubAckToBitmap(srcAddress, srcPort, topicId, msgId);
+            return;
+        }
+
         sendMsgIdWithTopicIdPlus(srcAddress, srcPort, MsgType::PUBACK, topicId, msgId, ReturnCode::ACCEPTED);
         return;
     }
@@ -312,6 +408,7 @@ void MqttSNSubscriber::processPublish(inet::Packet* pk, const inet::L3Address& s
     dataInfo.topicIdType = topicIdType;
     dataInfo.retain = retain;
     dataInfo.data = data;
+    dataInfo.samples = samples;
     dataInfo.tagInfo = tagInfo;
 
     // save message data for reuse
@@ -340,11 +437,11 @@ void MqttSNSubscriber::processPubRel(inet::Packet* pk, const inet::L3Address& sr
         messageInfo.qos = QoS::QOS_TWO;
         messageInfo.retain = dataInfo.retain;
         messageInfo.data = dataInfo.data;
+        messageInfo.samples = dataInfo.samples;
         messageInfo.tagInfo = dataInfo.tagInfo;
 
         // handling QoS 2
-        printPublishMessage(messageInfo);
-        handlePublishMessageMetrics(messageInfo.tagInfo);
+        deliverPublishMessage(messageInfo);
 
         // after processing, delete the message from the map
         messages.erase(messageIt);
@@ -380,7 +477,7 @@ void MqttSNSubscriber::sendSubscribe(const inet::L3Address& destAddress, const i
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNSubscriber::sendUnsubscribe(const inet::L3Address& destAddress, const int& destPort, TopicIdType topicIdTypeFlag, uint16_t msgId,
@@ -406,7 +503,7 @@ void MqttSNSubscriber::sendUnsubscribe(const inet::L3Address& destAddress, const
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNSubscriber::sendMsgIdWithTopicIdPlus(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t topicId,
@@ -415,7 +512,7 @@ void MqttSNSubscriber::sendMsgIdWithTopicIdPlus(const inet::L3Address& destAddre
     inet::Packet* packet = PacketHelper::getMsgIdWithTopicIdPlusPacket(msgType, topicId, msgId, returnCode);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNSubscriber::sendBaseWithMsgId(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t msgId)
@@ -423,7 +520,22 @@ void MqttSNSubscriber::sendBaseWithMsgId(const inet::L3Address& destAddress, con
     inet::Packet* packet = PacketHelper::getBaseWithMsgIdPacket(msgType, msgId);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
+}
+
+void MqttSNSubscriber::sendAckBitmap(const inet::L3Address& destAddress, const int& destPort, uint16_t msgId, uint32_t bitmap)
+{
+    const auto& payload = inet::makeShared<MqttSNAckBitmap>();
+    payload->setMsgType(MsgType::ACKBITMAP);
+    payload->setMsgId(msgId);
+    payload->setBitmap(bitmap);
+    payload->setChunkLength(inet::B(payload->getLength()));
+
+    inet::Packet* packet = new inet::Packet("AckBitmapPacket");
+    packet->insertAtBack(payload);
+    MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
+
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNSubscriber::handleCheckConnectionEventCustom(const inet::L3Address& destAddress, const int& destPort)
@@ -462,6 +574,62 @@ void MqttSNSubscriber::handleUnsubscriptionEvent()
     MqttSNClient::scheduleRetransmissionWithMsgId(MsgType::UNSUBSCRIBE, MqttSNClient::currentMsgId);
 }
 
+void MqttSNSubscriber::handleAckBitmapEvent()
+{
+    flushAckBitmap();
+}
+
+void MqttSNSubscriber::addPubAckToBitmap(const inet::L3Address& destAddress, const int& destPort, uint16_t topicId, uint16_t msgId)
+{
+    // the stream of another gateway starts without a reference ID
+    if (destAddress != ackBitmapAddress || destPort != ackBitmapPort) {
+        flushAckBitmap();
+        ackBitmapAccumulator.reset();
+
+        ackBitmapAddress = destAddress;
+        ackBitmapPort = destPort;
+    }
+
+    // flush first if the message ID falls outside the window following the base
+    if (!ackBitmapAccumulator.isEmpty() && !ackBitmapAccumulator.fits(msgId)) {
+        flushAckBitmap();
+    }
+
+    if (ackBitmapAccumulator.isEmpty()) {
+        // the gateway draws message IDs from a pool shared by all its subscribers, so with a large fan-out
+        // consecutive IDs of this subscriber lie more than the window apart; acknowledge those right away
+        if (!ackBitmapAccumulator.follows(msgId)) {
+            ackBitmapAccumulator.skip(msgId);
+            sendMsgIdWithTopicIdPlus(destAddress, destPort, MsgType::PUBACK, topicId, msgId, ReturnCode::ACCEPTED);
+            return;
+        }
+
+        ackBitmapAccumulator.add(msgId);
+
+        scheduleClockEventAfter(ackBitmapWindow, ackBitmapEvent);
+        return;
+    }
+
+    ackBitmapAccumulator.add(msgId);
+
+    if (ackBitmapAccumulator.isFull()) {
+        flushAckBitmap();
+    }
+}
+
+void MqttSNSubscriber::flushAckBitmap()
+{
+    cancelEvent(ackBitmapEvent);
+
+    if (ackBitmapAccumulator.isEmpty()) {
+        return;
+    }
+
+    sendAckBitmap(ackBitmapAddress, ackBitmapPort, ackBitmapAccumulator.getBaseMsgId(), ackBitmapAccumulator.getMask());
+
+    ackBitmapAccumulator.clear();
+}
+
 void MqttSNSubscriber::populateItems()
 {
     json jsonData = json::parse(par("itemsJson").stringValue());
@@ -475,8 +643,8 @@ void MqttSNSubscriber::populateItems()
         // validate topic name length and type against specified criteria
         MqttSNApp::checkTopicLength(topicName.length(), topicIdType);
 
-        auto predefinedTopicIt = MqttSNClient::predefinedTopics.find(StringHelper::base64Encode(topicName));
-        bool isPredefined = predefinedTopicIt != MqttSNClient::predefinedTopics.end();
+        uint16_t predefinedTopicId = 0;
+        bool isPredefined = MqttSNClient::predefinedTopics.findTopicId(topicName, predefinedTopicId);
 
         // validate topic consistency
         MqttSNClient::checkTopicConsistency(topicName, topicIdType, isPredefined);
@@ -487,7 +655,7 @@ void MqttSNSubscriber::populateItems()
         itemInfo.qos = ConversionHelper::intToQoS(item["qos"]);
 
         if (isPredefined) {
-            itemInfo.topicId = predefinedTopicIt->second;
+            itemInfo.topicId = predefinedTopicId;
         }
 
         items[itemsKey++] = itemInfo;
@@ -509,6 +677,7 @@ ItemInfo* MqttSNSubscriber::findItemByTopicName(const std::string& topicName)
 
 void MqttSNSubscriber::resetAndPopulateTopics()
 {
+    leaveMulticastTopics();
     topics.clear();
 
     for (auto& pair : items) {
@@ -631,6 +800,44 @@ bool MqttSNSubscriber::proceedWithUnsubscription()
     return true;
 }
 
+void MqttSNSubscriber::joinMulticastTopic(uint16_t topicId)
+{
+    if (!MqttSNApp::isMulticastEnabled() || multicastGroups.find(topicId) != multicastGroups.end()) {
+        return;
+    }
+
+    // the gateway may deliver QoS -1 and QoS 0 publications of this topic to its group
+    inet::L3Address multicastGroup = MqttSNApp::getMulticastGroup(MqttSNClient::selectedGatewayId, topicId);
+    multicastGroups[topicId] = multicastGroup;
+
+    MqttSNApp::socket.joinMulticastGroup(multicastGroup);
+}
+
+void MqttSNSubscriber::leaveMulticastTopic(const std::string& topicName)
+{
+    for (const auto& pair : topics) {
+        if (pair.second.topicName != topicName) {
+            continue;
+        }
+
+        auto groupIt = multicastGroups.find(pair.first);
+        if (groupIt != multicastGroups.end()) {
+            MqttSNApp::socket.leaveMulticastGroup(groupIt->second);
+            multicastGroups.erase(groupIt);
+        }
+    }
+}
+
+void MqttSNSubscriber::leaveMulticastTopics()
+{
+    // groups are left by address since the gateway that assigned them may no longer be selected
+    for (const auto& pair : multicastGroups) {
+        MqttSNApp::socket.leaveMulticastGroup(pair.second);
+    }
+
+    multicastGroups.clear();
+}
+
 void MqttSNSubscriber::printPublishMessage(const MessageInfo& messageInfo)
 {
     EV << "Received publish message:" << std::endl;
@@ -645,6 +852,29 @@ void MqttSNSubscriber::printPublishMessage(const MessageInfo& messageInfo)
     EV << "ID tag: " << messageInfo.tagInfo.identifier << std::endl;
 }
 
+void MqttSNSubscriber::deliverPublishMessage(const MessageInfo& messageInfo)
+{
+    if (messageInfo.samples.empty()) {
+        printPublishMessage(messageInfo);
+        handlePublishMessageMetrics(messageInfo.tagInfo);
+        return;
+    }
+
+    // each sample of a batch counts as a publication of its own
+    const auto& sampleTags = messageInfo.tagInfo.samples;
+
+    MessageInfo sampleInfo = messageInfo;
+    sampleInfo.samples.clear();
+
+    for (size_t i = 0; i < messageInfo.samples.size(); i++) {
+        sampleInfo.data = messageInfo.samples[i];
+        sampleInfo.tagInfo = (sampleTags != nullptr && i < sampleTags->size()) ? sampleTags->at(i) : TagInfo();
+
+        printPublishMessage(sampleInfo);
+        handlePublishMessageMetrics(sampleInfo.tagInfo);
+    }
+}
+
 void MqttSNSubscriber::handlePublishMessageMetrics(const TagInfo& tagInfo)
 {
     // return if the tag information is not valid
@@ -661,34 +891,35 @@ void MqttSNSubscriber::handlePublishMessageMetrics(const TagInfo& tagInfo)
     MqttSNClient::sumReceivedPublishMsgTimestamps += endToEndDelay.dbl();
     MqttSNClient::receivedTotalPublishMsgs++;
 
-    // duplicate detection
-    auto identifierIt = instancePublishMsgIdentifiers.find(tagInfo.identifier);
-    if (identifierIt == instancePublishMsgIdentifiers.end()) {
-        // insert the message identifier into the instance set to track distinct messages
-        instancePublishMsgIdentifiers.insert(tagInfo.identifier);
-    }
-    else {
+    // duplicate detection over the recent identifiers received by this subscriber and by any subscriber
+    SightingType instanceSighting = instanceDuplicateDetector.markSeen(tagInfo.identifier);
+    SightingType deliverySighting = deliveryDetector.markSeen(tagInfo.identifier);
+
+    if (instanceSighting == SightingType::DUPLICATE_SIGHTING) {
         // increment the count of duplicate publish messages received so far
         MqttSNClient::receivedDuplicatePublishMsgs++;
     }
+    else if (instanceSighting == SightingType::STALE_SIGHTING || deliverySighting == SightingType::STALE_SIGHTING) {
+        // late arrivals, e.g. a drained sleep buffer, are reported apart since they cannot be classified
+        MqttSNClient::receivedStalePublishMsgs++;
+    }
 
-    // insert the message identifier into the set to track distinct messages
-    publishMsgIdentifiers.insert(tagInfo.identifier);
-
-    // count of unique publish messages received so far
-    MqttSNClient::receivedUniquePublishMsgs = publishMsgIdentifiers.size();
+    // count of unique publish messages received so far by any subscriber
+    if (deliverySighting == SightingType::NEW_SIGHTING) {
+        MqttSNClient::receivedUniquePublishMsgs++;
+    }
 }
 
-void MqttSNSubscriber::handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg,
-                                                       MsgType msgType)
+void MqttSNSubscriber::handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort,
+                                                       const RetransmissionInfo& retransmissionInfo, MsgType msgType)
 {
     switch (msgType) {
         case MsgType::SUBSCRIBE:
-            retransmitSubscribe(destAddress, destPort, msg);
+            retransmitSubscribe(destAddress, destPort, retransmissionInfo);
             break;
 
         case MsgType::UNSUBSCRIBE:
-            retransmitUnsubscribe(destAddress, destPort, msg);
+            retransmitUnsubscribe(destAddress, destPort, retransmissionInfo);
             break;
 
         default:
@@ -701,23 +932,23 @@ void MqttSNSubscriber::updateRetransmissionsCounter()
     MqttSNClient::subscribersRetransmissions++;
 }
 
-void MqttSNSubscriber::retransmitSubscribe(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg)
+void MqttSNSubscriber::retransmitSubscribe(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo)
 {
     TopicIdType topicIdType = lastSubscription.itemInfo->topicIdType;
 
     sendSubscribe(MqttSNClient::selectedGateway.address, MqttSNClient::selectedGateway.port, true, lastSubscription.itemInfo->qos,
-                  topicIdType, std::stoi(msg->par("msgId").stringValue()), lastSubscription.topicName, lastSubscription.itemInfo->topicId,
+                  topicIdType, retransmissionInfo.msgId, lastSubscription.topicName, lastSubscription.itemInfo->topicId,
                   (topicIdType == TopicIdType::PRE_DEFINED_TOPIC_ID));
 
     MqttSNClient::subscribersRetransmissions++;
 }
 
-void MqttSNSubscriber::retransmitUnsubscribe(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg)
+void MqttSNSubscriber::retransmitUnsubscribe(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo)
 {
     TopicIdType topicIdType = lastUnsubscription.itemInfo->topicIdType;
 
     sendUnsubscribe(MqttSNClient::selectedGateway.address, MqttSNClient::selectedGateway.port, topicIdType,
-                    std::stoi(msg->par("msgId").stringValue()), lastUnsubscription.topicName, lastUnsubscription.itemInfo->topicId,
+                    retransmissionInfo.msgId, lastUnsubscription.topicName, lastUnsubscription.itemInfo->topicId,
                     (topicIdType == TopicIdType::PRE_DEFINED_TOPIC_ID));
 
     MqttSNClient::subscribersRetransmissions++;
@@ -727,6 +958,7 @@ MqttSNSubscriber::~MqttSNSubscriber()
 {
     cancelAndDelete(subscriptionEvent);
     cancelAndDelete(unsubscriptionEvent);
+    cancelAndDelete(ackBitmapEvent);
 }
 
 } /* namespace mqttsn */
@@ -2,6 +2,8 @@
 #define MODULES_CLIENT_MQTTSNSUBSCRIBER_H_
 
 #include "MqttSNClient.h"
+#include "helpers/DuplicateDetector.h"
+#include "helpers/AckBitmapAccumulator.h"
 #include "types/shared/QoS.h"
 #include "types/shared/TopicIdType.h"
 #include "types/shared/ReturnCode.h"
@@ -36,13 +38,26 @@ class MqttSNSubscriber : public MqttSNClient
 
         std::map<uint16_t, DataInfo> messages;
 
+        std::map<uint16_t, inet::L3Address> multicastGroups;
+
+        inet::ClockEvent* ackBitmapEvent = nullptr;
+        double ackBitmapWindow;
+        AckBitmapAccumulator ackBitmapAccumulator;
+        inet::L3Address ackBitmapAddress;
+        int ackBitmapPort = 0;
+
         // metrics attributes
-        std::set<unsigned> instancePublishMsgIdentifiers;
-        static std::set<unsigned> publishMsgIdentifiers;
+        DuplicateDetector instanceDuplicateDetector;
+        static DuplicateDetector deliveryDetector;
+        static int deliveryWindow;
+
+        unsigned decompressedPublishMsgs = 0;
+        double decodingTime = 0;
 
     protected:
         // initialization
         virtual void levelTwoInit() override;
+        virtual void finish() override;
 
         // message handling
         virtual bool handleMessageWhenUpCustom(omnetpp::cMessage* msg) override;
@@ -76,11 +91,13 @@ class MqttSNSubscriber : public MqttSNClient
                                               uint16_t msgId, ReturnCode returnCode);
 
         virtual void sendBaseWithMsgId(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t msgId);
+        virtual void sendAckBitmap(const inet::L3Address& destAddress, const int& destPort, uint16_t msgId, uint32_t bitmap);
 
         // event handlers
         virtual void handleCheckConnectionEventCustom(const inet::L3Address& destAddress, const int& destPort) override;
         virtual void handleSubscriptionEvent();
         virtual void handleUnsubscriptionEvent();
+        virtual void handleAckBitmapEvent();
 
         // item methods
         virtual void populateItems() override;
@@ -93,18 +110,28 @@ class MqttSNSubscriber : public MqttSNClient
         virtual bool proceedWithSubscription();
         virtual bool proceedWithUnsubscription();
 
+        // multicast methods
+        virtual void joinMulticastTopic(uint16_t topicId);
+        virtual void leaveMulticastTopic(const std::string& topicName);
+        virtual void leaveMulticastTopics();
+
+        // bitmap acknowledgement methods
+        virtual void addPubAckToBitmap(const inet::L3Address& destAddress, const int& destPort, uint16_t topicId, uint16_t msgId);
+        virtual void flushAckBitmap();
+
         // publication methods
         virtual void printPublishMessage(const MessageInfo& messageInfo);
+        virtual void deliverPublishMessage(const MessageInfo& messageInfo);
         virtual void handlePublishMessageMetrics(const TagInfo& tagInfo);
 
         // retransmission management
-        virtual void handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg,
-                                                     MsgType msgType) override;
+        virtual void handleRetransmissionEventCustom(const inet::L3Address& destAddress, const int& destPort,
+                                                     const RetransmissionInfo& retransmissionInfo, MsgType msgType) override;
 
         virtual void updateRetransmissionsCounter() override;
 
-        virtual void retransmitSubscribe(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg);
-        virtual void retransmitUnsubscribe(const inet::L3Address& destAddress, const int& destPort, omnetpp::cMessage* msg);
+        virtual void retransmitSubscribe(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo);
+        virtual void retransmitUnsubscribe(const inet::L3Address& destAddress, const int& destPort, const RetransmissionInfo& retransmissionInfo);
 
     public:
         MqttSNSubscriber() {};
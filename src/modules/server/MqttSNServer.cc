@@ -2,16 +2,15 @@
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include "inet/networklayer/common/L3AddressTag_m.h"
 #include "inet/transportlayer/common/L4PortTag_m.h"
-#include "inet/common/TimeTag_m.h"
 #include "helpers/StringHelper.h"
 #include "helpers/PacketHelper.h"
 #include "helpers/NumericHelper.h"
 #include "types/shared/Length.h"
-#include "tags/IdentifierTag.h"
 #include "messages/MqttSNAdvertise.h"
 #include "messages/MqttSNConnect.h"
+#include "messages/MqttSNConnAck.h"
+#include "messages/MqttSNAckBitmap.h"
 #include "messages/MqttSNBase.h"
-#include "messages/MqttSNBaseWithReturnCode.h"
 #include "messages/MqttSNBaseWithWillTopic.h"
 #include "messages/MqttSNBaseWithWillMsg.h"
 #include "messages/MqttSNDisconnect.h"
@@ -39,11 +38,23 @@ void MqttSNServer::levelOneInit()
 
     gatewayIdCounter = -1;
 
-    activeClientsCheckInterval = par("activeClientsCheckInterval");
-    activeClientsCheckEvent = new inet::ClockEvent("activeClientsCheckTimer");
+    pingRespWaitInterval = par("pingRespWaitInterval");
 
-    asleepClientsCheckInterval = par("asleepClientsCheckInterval");
-    asleepClientsCheckEvent = new inet::ClockEvent("asleepClientsCheckTimer");
+    // congestion caps the table at maximumClients slots
+    clientSlots.reserve(std::max((int) par("maximumClients"), 0));
+
+    clientsSupervisionEvent = new inet::ClockEvent("clientsSupervisionTimer");
+
+    multicastFanOutThreshold = par("multicastFanOutThreshold");
+
+    omnetpp::cStringTokenizer multicastTopicsTokenizer(par("multicastTopics").stringValue());
+    while (multicastTopicsTokenizer.hasMoreTokens()) {
+        multicastTopics.insert(multicastTopicsTokenizer.nextToken());
+    }
+
+    multicastPublishMsgs = 0;
+    multicastSavedPublishMsgs = 0;
+    multicastSavedBytes = 0;
 
     fillWithPredefinedTopics();
 
@@ -53,17 +64,23 @@ void MqttSNServer::levelOneInit()
     requestsCheckInterval = par("requestsCheckInterval");
     requestsCheckEvent = new inet::ClockEvent("requestsCheckTimer");
 
-    registrationsCheckInterval = par("registrationsCheckInterval");
-    registrationsCheckEvent = new inet::ClockEvent("registrationsCheckTimer");
+    retransmissionEvent = new inet::ClockEvent("retransmissionTimer");
 
-    awakenSubscriberCheckInterval = par("awakenSubscriberCheckInterval");
+    ackBitmapWindow = par("ackBitmapWindow");
+    ackBitmapEvent = new inet::ClockEvent("ackBitmapTimer");
 
-    messagesClearInterval = par("messagesClearInterval");
-    messagesClearEvent = new inet::ClockEvent("messagesClearTimer");
+    awakenSubscriberCheckInterval = par("awakenSubscriberCheckInterval");
 }
 
 void MqttSNServer::finish()
 {
+    if (MqttSNApp::isMulticastEnabled()) {
+        // transmissions and bytes a per-subscriber unicast fan-out would have added
+        recordScalar("multicastPublishMsgs", multicastPublishMsgs);
+        recordScalar("multicastSavedPublishMsgs", multicastSavedPublishMsgs);
+        recordScalar("multicastSavedBytes", multicastSavedBytes, "B");
+    }
+
     clearPublishersData();
     clearSubscribersData();
 
@@ -89,12 +106,14 @@ void MqttSNServer::handleStopOperation(inet::LifecycleOperation* operation)
     cancelEvent(stateChangeEvent);
     cancelOnlineStateEvents();
 
+    MqttSNApp::flushCoalescedPackets();
     MqttSNApp::socket.close();
 }
 
 void MqttSNServer::handleCrashOperation(inet::LifecycleOperation* operation)
 {
     cancelOnlineStateClockEvents();
+    MqttSNApp::clearCoalescedPackets();
 
     MqttSNApp::socket.destroy();
 }
@@ -107,11 +126,8 @@ void MqttSNServer::handleMessageWhenUp(omnetpp::cMessage* msg)
     else if (msg == advertiseEvent) {
         handleAdvertiseEvent();
     }
-    else if (msg == activeClientsCheckEvent) {
-        handleActiveClientsCheckEvent();
-    }
-    else if (msg == asleepClientsCheckEvent) {
-        handleAsleepClientsCheckEvent();
+    else if (msg == clientsSupervisionEvent) {
+        handleClientsSupervisionEvent();
     }
     else if (msg == pendingRetainCheckEvent) {
         handlePendingRetainCheckEvent();
@@ -119,14 +135,17 @@ void MqttSNServer::handleMessageWhenUp(omnetpp::cMessage* msg)
     else if (msg == requestsCheckEvent) {
         handleRequestsCheckEvent();
     }
-    else if (msg == registrationsCheckEvent) {
-        handleRegistrationsCheckEvent();
+    else if (msg == retransmissionEvent) {
+        handleRetransmissionEvent();
+    }
+    else if (msg == ackBitmapEvent) {
+        handleAckBitmapEvent();
     }
     else if (msg->hasPar("isAwakenSubscriberCheckEvent")) {
         handleAwakenSubscriberCheckEvent(msg);
     }
-    else if (msg == messagesClearEvent) {
-        handleMessagesClearEvent();
+    else if (msg == MqttSNApp::coalescingEvent) {
+        MqttSNApp::handleCoalescingEvent();
     }
     else {
         MqttSNApp::socket.processMessage(msg);
@@ -159,35 +178,37 @@ void MqttSNServer::updateCurrentState(GatewayState nextState)
 void MqttSNServer::scheduleOnlineStateEvents()
 {
     scheduleClockEventAfter(advertiseInterval, advertiseEvent);
-    scheduleClockEventAfter(activeClientsCheckInterval, activeClientsCheckEvent);
-    scheduleClockEventAfter(asleepClientsCheckInterval, asleepClientsCheckEvent);
     scheduleClockEventAfter(pendingRetainCheckInterval, pendingRetainCheckEvent);
-    scheduleClockEventAfter(requestsCheckInterval, requestsCheckEvent);
-    scheduleClockEventAfter(registrationsCheckInterval, registrationsCheckEvent);
-    scheduleClockEventAfter(messagesClearInterval, messagesClearEvent);
+
+    // resume pending work left from the previous online period
+    if (!readySubscribers.empty()) {
+        scheduleClockEventAfter(requestsCheckInterval, requestsCheckEvent);
+    }
+
+    armClientsSupervisionEvent();
+    armRetransmissionEvent();
+    armAckBitmapEvent();
 }
 
 void MqttSNServer::cancelOnlineStateEvents()
 {
     cancelEvent(advertiseEvent);
-    cancelEvent(activeClientsCheckEvent);
-    cancelEvent(asleepClientsCheckEvent);
+    cancelEvent(clientsSupervisionEvent);
     cancelEvent(pendingRetainCheckEvent);
     cancelEvent(requestsCheckEvent);
-    cancelEvent(registrationsCheckEvent);
-    cancelEvent(messagesClearEvent);
+    cancelEvent(retransmissionEvent);
+    cancelEvent(ackBitmapEvent);
 }
 
 void MqttSNServer::cancelOnlineStateClockEvents()
 {
     cancelClockEvent(stateChangeEvent);
     cancelClockEvent(advertiseEvent);
-    cancelClockEvent(activeClientsCheckEvent);
-    cancelClockEvent(asleepClientsCheckEvent);
+    cancelClockEvent(clientsSupervisionEvent);
     cancelClockEvent(pendingRetainCheckEvent);
     cancelClockEvent(requestsCheckEvent);
-    cancelClockEvent(registrationsCheckEvent);
-    cancelClockEvent(messagesClearEvent);
+    cancelClockEvent(retransmissionEvent);
+    cancelClockEvent(ackBitmapEvent);
 }
 
 bool MqttSNServer::fromOfflineToOnline()
@@ -386,6 +407,10 @@ void MqttSNServer::processPacketByMessageType(inet::Packet* pk, const inet::L3Ad
             processPubComp(pk, srcAddress, srcPort);
             break;
 
+        case MsgType::ACKBITMAP:
+            processAckBitmap(pk, clientInfo);
+            break;
+
         default:
             break;
     }
@@ -393,6 +418,8 @@ void MqttSNServer::processPacketByMessageType(inet::Packet* pk, const inet::L3Ad
 
 bool MqttSNServer::isValidPacket(const inet::L3Address& srcAddress, const int& srcPort, MsgType msgType, ClientInfo*& clientInfo)
 {
+    uint32_t clientHandle = INVALID_CLIENT_HANDLE;
+
     switch(msgType) {
         // packet types that require an ACTIVE client state
         case MsgType::WILLTOPIC:
@@ -406,21 +433,24 @@ bool MqttSNServer::isValidPacket(const inet::L3Address& srcAddress, const int& s
         case MsgType::SUBSCRIBE:
         case MsgType::UNSUBSCRIBE:
         case MsgType::REGACK:
-            clientInfo = getClientInfo(srcAddress, srcPort);
+            clientHandle = getClientHandle(srcAddress, srcPort);
+            clientInfo = getClientInfo(clientHandle);
 
             // discard packet if client is not found or not in ACTIVE state
             if (clientInfo == nullptr || (clientInfo->currentState != ClientState::ACTIVE)) {
                 return false;
             }
 
-            clientInfo->lastReceivedMsgTime = getClockTime();
+            refreshClientActivity(clientHandle, clientInfo);
             break;
 
         // packet types that require an ACTIVE or AWAKE client state
         case MsgType::PUBACK:
         case MsgType::PUBREC:
         case MsgType::PUBCOMP:
-            clientInfo = getClientInfo(srcAddress, srcPort);
+        case MsgType::ACKBITMAP:
+            clientHandle = getClientHandle(srcAddress, srcPort);
+            clientInfo = getClientInfo(clientHandle);
 
             // discard packet if client is not found or not in ACTIVE or AWAKE state
             if (clientInfo == nullptr ||
@@ -429,13 +459,14 @@ bool MqttSNServer::isValidPacket(const inet::L3Address& srcAddress, const int& s
                 return false;
             }
 
-            clientInfo->lastReceivedMsgTime = getClockTime();
+            refreshClientActivity(clientHandle, clientInfo);
             break;
 
         // packet types that require an ACTIVE or ASLEEP client state
         case MsgType::PINGREQ:
         case MsgType::DISCONNECT:
-            clientInfo = getClientInfo(srcAddress, srcPort);
+            clientHandle = getClientHandle(srcAddress, srcPort);
+            clientInfo = getClientInfo(clientHandle);
 
             // discard packet if client is not found or not in ACTIVE or ASLEEP state
             if (clientInfo == nullptr ||
@@ -444,7 +475,7 @@ bool MqttSNServer::isValidPacket(const inet::L3Address& srcAddress, const int& s
                 return false;
             }
 
-            clientInfo->lastReceivedMsgTime = getClockTime();
+            refreshClientActivity(clientHandle, clientInfo);
             break;
 
         default:
@@ -456,7 +487,7 @@ bool MqttSNServer::isValidPacket(const inet::L3Address& srcAddress, const int& s
 
 void MqttSNServer::processSearchGw()
 {
-    MqttSNApp::sendGwInfo(gatewayId);
+    MqttSNApp::sendGwInfo(gatewayId, "", 0, getLoadHint());
 }
 
 void MqttSNServer::processConnect(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort)
@@ -514,9 +545,20 @@ void MqttSNServer::processConnect(inet::Packet* pk, const inet::L3Address& srcAd
 
     // update client information
     clientInfo->keepAliveDuration = payload->getDuration();
-    clientInfo->currentState = ClientState::ACTIVE;
+    updateClientState(getClientHandle(srcAddress, srcPort), clientInfo, ClientState::ACTIVE);
     clientInfo->lastReceivedMsgTime = getClockTime();
 
+    // bitmap acknowledgements are renegotiated on every connection
+    clientInfo->ackBitmap = par("ackBitmap").boolValue() && payload->getAckBitmapFlag();
+
+    uint32_t clientHandle = getClientHandle(srcAddress, srcPort);
+
+    // supervise the keep alive duration negotiated in this connection
+    updateClientSupervision(clientHandle, clientInfo);
+
+    // resume queued requests if the client is a returning subscriber
+    markSubscriberReady(clientHandle);
+
     bool will = payload->getWillFlag();
 
     if (will) {
@@ -528,7 +570,7 @@ void MqttSNServer::processConnect(inet::Packet* pk, const inet::L3Address& srcAd
         return;
     }
 
-    sendBaseWithReturnCode(srcAddress, srcPort, MsgType::CONNACK, ReturnCode::ACCEPTED);
+    sendConnAck(srcAddress, srcPort, clientInfo);
 }
 
 void MqttSNServer::processWillTopic(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort, bool isDirectUpdate)
@@ -562,7 +604,7 @@ void MqttSNServer::processWillMsg(inet::Packet* pk, const inet::L3Address& srcAd
         return;
     }
 
-    sendBaseWithReturnCode(srcAddress, srcPort, MsgType::CONNACK, ReturnCode::ACCEPTED);
+    sendConnAck(srcAddress, srcPort, getClientInfo(srcAddress, srcPort));
 }
 
 void MqttSNServer::processPingReq(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort, ClientInfo* clientInfo)
@@ -580,8 +622,12 @@ void MqttSNServer::processPingReq(inet::Packet* pk, const inet::L3Address& srcAd
             // handle subscriber-related tasks at PINGREQ
             handleSubscriberPingRequest(srcAddress, srcPort);
 
-            // update subscriber state
-            clientInfo->currentState = ClientState::AWAKE;
+            uint32_t subscriberHandle = getClientHandle(srcAddress, srcPort);
+
+            // update subscriber state and resume its queued requests; an AWAKE client is not supervised
+            updateClientState(subscriberHandle, clientInfo, ClientState::AWAKE);
+            updateClientSupervision(subscriberHandle, clientInfo);
+            markSubscriberReady(subscriberHandle);
             return;
         }
     }
@@ -604,7 +650,10 @@ void MqttSNServer::processDisconnect(inet::Packet* pk, const inet::L3Address& sr
 
     // update client information
     clientInfo->sleepDuration = sleepDuration;
-    clientInfo->currentState = (sleepDuration > 0) ? ClientState::ASLEEP : ClientState::DISCONNECTED;
+    updateClientState(getClientHandle(srcAddress, srcPort), clientInfo, (sleepDuration > 0) ? ClientState::ASLEEP : ClientState::DISCONNECTED);
+
+    // switch from keep alive to sleep supervision, or stop supervising the disconnected client
+    updateClientSupervision(getClientHandle(srcAddress, srcPort), clientInfo);
 
     // ACK with disconnect message
     MqttSNApp::sendDisconnect(srcAddress, srcPort, sleepDuration);
@@ -626,23 +675,20 @@ void MqttSNServer::processRegister(inet::Packet* pk, const inet::L3Address& srcA
         return;
     }
 
-    // encode the sanitized topic name to Base64 for consistent key handling
-    std::string encodedTopicName = StringHelper::base64Encode(topicName);
-
     // check if the topic is already registered; if yes, send ACCEPTED response, otherwise register the topic
-    auto it = topicsToIds.find(encodedTopicName);
-    if (it != topicsToIds.end()) {
-        sendMsgIdWithTopicIdPlus(srcAddress, srcPort, MsgType::REGACK, it->second, msgId, ReturnCode::ACCEPTED);
+    uint16_t registeredTopicId;
+    if (topicRegistry.findTopicId(topicName, registeredTopicId)) {
+        sendMsgIdWithTopicIdPlus(srcAddress, srcPort, MsgType::REGACK, registeredTopicId, msgId, ReturnCode::ACCEPTED);
         return;
     }
 
     // check if the maximum number of topics is reached; if not, set a new available topic ID
-    if (!MqttSNApp::setNextAvailableId(topicIds, currentTopicId, false)) {
+    if (!topicIds.allocate(currentTopicId)) {
         sendMsgIdWithTopicIdPlus(srcAddress, srcPort, MsgType::REGACK, topicId, msgId, ReturnCode::REJECTED_CONGESTION);
         return;
     }
 
-    addNewTopic(encodedTopicName, currentTopicId, getTopicIdType(topicLength));
+    addNewTopic(topicName, currentTopicId, getTopicIdType(topicLength));
 
     // send REGACK response with the new topic ID and ACCEPTED status
     sendMsgIdWithTopicIdPlus(srcAddress, srcPort, MsgType::REGACK, currentTopicId, msgId, ReturnCode::ACCEPTED);
@@ -679,16 +725,16 @@ void MqttSNServer::processPublish(inet::Packet* pk, const inet::L3Address& srcAd
     }
 
     bool dup = payload->getDupFlag();
-    std::string data = payload->getData();
+    // keep a reference to the received payload bytes; stored records and outgoing chunks share them
+    const PayloadBuffer& data = payload->getSharedData();
+    bool compressed = payload->getCompressionFlag();
 
     if (retain) {
         // add a new retained message for the specified topic
-        addNewRetainMessage(topicId, dup, qos, topicIdType, data);
+        addNewRetainMessage(topicId, dup, qos, topicIdType, data, compressed);
     }
 
-    TagInfo tagInfo;
-    tagInfo.timestamp = inet::ClockTime::SIMTIME_AS_CLOCKTIME(payload->findTag<inet::CreationTimeTag>()->getCreationTime());
-    tagInfo.identifier = payload->findTag<IdentifierTag>()->getIdentifier();
+    TagInfo tagInfo = PacketHelper::getTagInfo(payload);
 
     MessageInfo messageInfo;
     messageInfo.topicId = topicId;
@@ -697,6 +743,7 @@ void MqttSNServer::processPublish(inet::Packet* pk, const inet::L3Address& srcAd
     messageInfo.qos = qos;
     messageInfo.retain = retain;
     messageInfo.data = data;
+    messageInfo.compressed = compressed;
     messageInfo.tagInfo = tagInfo;
 
     if (qos == QoS::QOS_ZERO) {
@@ -708,6 +755,16 @@ void MqttSNServer::processPublish(inet::Packet* pk, const inet::L3Address& srcAd
     if (qos == QoS::QOS_ONE) {
         // handling QoS 1
         dispatchPublishToSubscribers(messageInfo);
+
+        // batch the acknowledgement when negotiated with the publisher
+        uint32_t publisherHandle = getClientHandle(srcAddress, srcPort);
+        ClientInfo* clientInfo = getClientInfo(publisherHandle);
+
+        if (clientInfo != nullptr && clientInfo->ackBitmap && msgId > 0) {
+            addPubAckToBitmap(publisherHandle, getPublisherInfo(srcAddress, srcPort, true), msgId);
+            return;
+        }
+
         sendMsgIdWithTopicIdPlus(srcAddress, srcPort, MsgType::PUBACK, topicId, msgId, ReturnCode::ACCEPTED);
         return;
     }
@@ -726,6 +783,7 @@ void MqttSNServer::processPublish(inet::Packet* pk, const inet::L3Address& srcAd
     dataInfo.topicIdType = topicIdType;
     dataInfo.retain = retain;
     dataInfo.data = data;
+    dataInfo.compressed = compressed;
     dataInfo.tagInfo = tagInfo;
 
     // save message data for reuse
@@ -739,17 +797,60 @@ void MqttSNServer::processPublishMinusOne(inet::Packet* pk)
 {
     const auto& payload = pk->peekData<MqttSNPublish>();
     uint16_t topicId = payload->getTopicId();
-    TopicIdType topicIdType = (TopicIdType) payload->getTopicIdTypeFlag();
 
-    // handle the case where the topic is not registered or inconsistencies are detected
-    auto it = idsToTopics.find(topicId);
-    if (it == idsToTopics.end() || it->second.topicIdType != topicIdType || topicIdType != TopicIdType::PRE_DEFINED_TOPIC_ID) {
+    // only predefined topics are allowed; the route exists only for those
+    if ((TopicIdType) payload->getTopicIdTypeFlag() != TopicIdType::PRE_DEFINED_TOPIC_ID) {
+        return;
+    }
+
+    auto topicIt = idsToTopics.find(topicId);
+    if (topicIt == idsToTopics.end() || topicIt->second.topicIdType != TopicIdType::PRE_DEFINED_TOPIC_ID) {
         return;
     }
 
-    TagInfo tagInfo;
-    tagInfo.timestamp = inet::ClockTime::SIMTIME_AS_CLOCKTIME(payload->findTag<inet::CreationTimeTag>()->getCreationTime());;
-    tagInfo.identifier = payload->findTag<IdentifierTag>()->getIdentifier();
+    // multicast topics share the general dispatch and its fan-out threshold
+    bool isMulticast = topicIt->second.multicast;
+    std::vector<uint32_t> pendingHandles;
+
+    if (!isMulticast) {
+        auto routeIt = minusOneRoutes.find(topicId);
+        if (routeIt == minusOneRoutes.end()) {
+            return;
+        }
+
+        const MinusOneRoute& route = routeIt->second;
+
+        // a QoS -1 publication goes out with dup, retain and message ID cleared; normalise once for all subscribers
+        inet::Ptr<const MqttSNPublish> chunk = payload;
+
+        if (payload->getDupFlag() || payload->getRetainFlag() || payload->getMsgId() != 0) {
+            const auto& normalisedPayload = inet::staticPtrCast<MqttSNPublish>(payload->dupShared());
+            normalisedPayload->setDupFlag(false);
+            normalisedPayload->setRetainFlag(false);
+            normalisedPayload->setMsgId(0);
+            normalisedPayload->markImmutable();
+
+            chunk = normalisedPayload;
+        }
+
+        // forward the same chunk to every ready subscriber
+        for (const auto& endpoint : route.readyEndpoints) {
+            inet::Packet* packet = new inet::Packet("PublishPacket");
+            packet->insertAtBack(chunk);
+            MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
+
+            MqttSNApp::sendPacket(packet, endpoint.first, endpoint.second);
+        }
+
+        if (route.pendingHandles.empty()) {
+            return;
+        }
+
+        // copied since buffering or registering may update the route
+        pendingHandles = route.pendingHandles;
+    }
+
+    TagInfo tagInfo = PacketHelper::getTagInfo(payload);
 
     MessageInfo messageInfo;
     messageInfo.topicId = topicId;
@@ -757,18 +858,29 @@ void MqttSNServer::processPublishMinusOne(inet::Packet* pk)
     messageInfo.dup = false;
     messageInfo.qos = QoS::QOS_MINUS_ONE;
     messageInfo.retain = false;
-    messageInfo.data = payload->getData();
+    messageInfo.data = payload->getSharedData();
+    messageInfo.compressed = payload->getCompressionFlag();
     messageInfo.tagInfo = tagInfo;
 
     // handling QoS -1
-    dispatchPublishToSubscribers(messageInfo);
+    if (isMulticast) {
+        dispatchPublishToSubscribers(messageInfo);
+        return;
+    }
+
+    // only the asleep and unregistered subscribers need the buffered path
+    bool isMessageAdded = false;
+
+    for (uint32_t subscriberHandle : pendingHandles) {
+        dispatchPublishToSubscriber(getSubscriberClientSlot(subscriberHandle), QoS::QOS_MINUS_ONE, messageInfo, isMessageAdded);
+    }
 }
 
 void MqttSNServer::processPubRel(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort)
 {
-    // check if the publisher exists for the given key
-    auto publisherIt = publishers.find(std::make_pair(srcAddress, srcPort));
-    if (publisherIt == publishers.end()) {
+    // check if the publisher exists for the given address and port
+    PublisherInfo* publisherInfo = getPublisherInfo(srcAddress, srcPort);
+    if (publisherInfo == nullptr) {
         return;
     }
 
@@ -776,7 +888,7 @@ void MqttSNServer::processPubRel(inet::Packet* pk, const inet::L3Address& srcAdd
     uint16_t msgId = payload->getMsgId();
 
     // access the messages associated with the publisher
-    std::map<uint16_t, DataInfo>& messages = publisherIt->second.messages;
+    std::map<uint16_t, DataInfo>& messages = publisherInfo->messages;
 
     // check if the message exists for the given message ID
     auto messageIt = messages.find(msgId);
@@ -791,6 +903,7 @@ void MqttSNServer::processPubRel(inet::Packet* pk, const inet::L3Address& srcAdd
         messageInfo.qos = QoS::QOS_TWO;
         messageInfo.retain = dataInfo.retain;
         messageInfo.data = dataInfo.data;
+        messageInfo.compressed = dataInfo.compressed;
         messageInfo.tagInfo = dataInfo.tagInfo;
 
         // handling QoS 2
@@ -832,24 +945,17 @@ void MqttSNServer::processSubscribe(inet::Packet* pk, const inet::L3Address& src
             return;
         }
 
-        // encode the sanitized topic name to Base64 for consistent key handling
-        std::string encodedTopicName = StringHelper::base64Encode(topicName);
-
         // check if the topic is already registered; if not, register it
-        auto it = topicsToIds.find(encodedTopicName);
-        if (it == topicsToIds.end()) {
+        if (!topicRegistry.findTopicId(topicName, topicId)) {
             // check if the maximum number of topics is reached; if not, set a new available topic ID
-            if (!MqttSNApp::setNextAvailableId(topicIds, currentTopicId, false)) {
+            if (!topicIds.allocate(currentTopicId)) {
                 sendSubAck(srcAddress, srcPort, qos, 0, msgId, ReturnCode::REJECTED_CONGESTION);
                 return;
             }
 
-            addNewTopic(encodedTopicName, currentTopicId, getTopicIdType(topicLength));
+            addNewTopic(topicName, currentTopicId, getTopicIdType(topicLength));
             topicId = currentTopicId;
         }
-        else {
-            topicId = it->second;
-        }
     }
 
     // remove subscription if exists
@@ -861,8 +967,8 @@ void MqttSNServer::processSubscribe(inet::Packet* pk, const inet::L3Address& src
     // check for existing retain message and add in the queue if found
     addNewPendingRetainMessage(srcAddress, srcPort, topicId, qos);
 
-    // send ACK message with ACCEPTED code
-    sendSubAck(srcAddress, srcPort, qos, topicId, msgId, ReturnCode::ACCEPTED);
+    // send ACK message with ACCEPTED code; tell the subscriber whether to join the topic multicast group
+    sendSubAck(srcAddress, srcPort, qos, topicId, msgId, ReturnCode::ACCEPTED, idsToTopics[topicId].multicast);
 }
 
 void MqttSNServer::processUnsubscribe(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort)
@@ -882,9 +988,9 @@ void MqttSNServer::processUnsubscribe(inet::Packet* pk, const inet::L3Address& s
         std::string topicName = StringHelper::sanitizeSpaces(payload->getTopicName());
         // check and remove subscription if a valid topic name exists
         if (MqttSNApp::isMinTopicLength(topicName.length())) {
-            auto it = topicsToIds.find(StringHelper::base64Encode(topicName));
-            if (it != topicsToIds.end()) {
-                deleteSubscriptionIfExists(srcAddress, srcPort, it->second);
+            uint16_t registeredTopicId;
+            if (topicRegistry.findTopicId(topicName, registeredTopicId)) {
+                deleteSubscriptionIfExists(srcAddress, srcPort, registeredTopicId);
             }
         }
     }
@@ -922,8 +1028,12 @@ void MqttSNServer::processRegAck(inet::Packet* pk, const inet::L3Address& srcAdd
         return;
     }
 
-    // update topic registration status
+    // update topic registration status and resume the buffered requests for the topic
     subscriberTopicInfo->isRegistered = true;
+
+    uint32_t subscriberHandle = getClientHandle(srcAddress, srcPort);
+    updateMinusOneRoute(topicId, subscriberHandle);
+    markSubscriberReady(subscriberHandle);
 }
 
 void MqttSNServer::processPubAck(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort)
@@ -958,20 +1068,25 @@ void MqttSNServer::processPubRec(inet::Packet* pk, const inet::L3Address& srcAdd
     uint16_t msgId = payload->getMsgId();
 
     std::map<uint16_t, RequestInfo>::iterator requestIt;
-    std::set<uint16_t>::iterator requestIdIt;
 
     // check if the ACK is valid; exit if not
-    if (!isValidRequest(msgId, MsgType::PUBLISH, requestIt, requestIdIt)) {
+    if (!isValidRequest(msgId, MsgType::PUBLISH, requestIt)) {
         return;
     }
 
+    RequestInfo& requestInfo = requestIt->second;
+    sampleRoundTripTime(requestInfo.subscriberHandle, requestInfo.requestTime, requestInfo.retransmissionCounter);
+
     // send publish release
     sendBaseWithMsgId(srcAddress, srcPort, MsgType::PUBREL, msgId);
 
     // update the request
-    requestIt->second.requestTime = getClockTime();
-    requestIt->second.retransmissionCounter = 0;
-    requestIt->second.messageType = MsgType::PUBREL;
+    requestInfo.requestTime = getClockTime();
+    requestInfo.deadline = requestInfo.requestTime + MqttSNApp::getRetransmissionTimeout(srcAddress, srcPort, 0);
+    requestInfo.retransmissionCounter = 0;
+    requestInfo.messageType = MsgType::PUBREL;
+
+    addRetransmissionDeadline(requestInfo.deadline, false, msgId);
 }
 
 void MqttSNServer::processPubComp(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort)
@@ -984,52 +1099,99 @@ void MqttSNServer::processPubComp(inet::Packet* pk, const inet::L3Address& srcAd
     }
 }
 
+void MqttSNServer::processAckBitmap(inet::Packet* pk, ClientInfo* clientInfo)
+{
+    // ignore the extension if it was not negotiated with the client
+    if (!clientInfo->ackBitmap) {
+        return;
+    }
+
+    const auto& payload = pk->peekData<MqttSNAckBitmap>();
+    uint16_t msgId = payload->getMsgId();
+    uint32_t bitmap = payload->getBitmap();
+
+    // the base message ID is always acknowledged; stale or unknown IDs are skipped
+    processRequestAck(msgId, MsgType::PUBLISH);
+
+    for (uint16_t i = 0; bitmap != 0; i++, bitmap >>= 1) {
+        if (bitmap & 1) {
+            processRequestAck(msgId + 1 + i, MsgType::PUBLISH);
+        }
+    }
+}
+
+void MqttSNServer::sendAckBitmap(const inet::L3Address& destAddress, const int& destPort, uint16_t msgId, uint32_t bitmap)
+{
+    const auto& payload = inet::makeShared<MqttSNAckBitmap>();
+    payload->setMsgType(MsgType::ACKBITMAP);
+    payload->setMsgId(msgId);
+    payload->setBitmap(bitmap);
+    payload->setChunkLength(inet::B(payload->getLength()));
+
+    inet::Packet* packet = new inet::Packet("AckBitmapPacket");
+    packet->insertAtBack(payload);
+    MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
+
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
+}
+
 void MqttSNServer::sendAdvertise()
 {
     const auto& payload = inet::makeShared<MqttSNAdvertise>();
     payload->setMsgType(MsgType::ADVERTISE);
     payload->setGwId(gatewayId);
     payload->setDuration(advertiseInterval);
+    payload->setLoadHint(getLoadHint());
     payload->setChunkLength(inet::B(payload->getLength()));
 
     inet::Packet* packet = new inet::Packet("AdvertisePacket");
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, inet::L3Address(par("broadcastAddress")), par("destPort"));
+    MqttSNApp::sendPacket(packet, inet::L3Address(par("broadcastAddress")), par("destPort"));
 }
 
-void MqttSNServer::sendBaseWithReturnCode(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, ReturnCode returnCode)
+uint8_t MqttSNServer::getLoadHint()
 {
-    const auto& payload = inet::makeShared<MqttSNBaseWithReturnCode>();
-    payload->setMsgType(msgType);
-    payload->setReturnCode(returnCode);
-    payload->setChunkLength(inet::B(payload->getLength()));
+    if (!par("loadHint").boolValue()) {
+        return 0;
+    }
 
-    std::string packetName;
+    // percentage of the client capacity in use, capped at full capacity
+    unsigned maximumClients = std::max((int) par("maximumClients"), 1);
+    unsigned load = std::min(connectedClients * 100 / maximumClients, 100u);
 
-    switch(msgType) {
-        case MsgType::CONNACK:
-            packetName = "ConnAckPacket";
-            break;
+    // shifted by one so that an idle gateway is not mistaken for an omitted hint
+    return load + 1;
+}
 
-        case MsgType::WILLTOPICRESP:
-            packetName = "WillTopicRespPacket";
-            break;
+void MqttSNServer::sendBaseWithReturnCode(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, ReturnCode returnCode)
+{
+    inet::Packet* packet = PacketHelper::getBaseWithReturnCodePacket(msgType, returnCode);
+    MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-        case MsgType::WILLMSGRESP:
-            packetName = "WillMsgRespPacket";
-            break;
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
+}
 
-        default:
-            packetName = "BaseWithReturnCodePacket";
+void MqttSNServer::sendConnAck(const inet::L3Address& destAddress, const int& destPort, ClientInfo* clientInfo)
+{
+    // plain peers get the standard CONNACK without the extensions octet
+    if (clientInfo == nullptr || !clientInfo->ackBitmap) {
+        sendBaseWithReturnCode(destAddress, destPort, MsgType::CONNACK, ReturnCode::ACCEPTED);
+        return;
     }
 
-    inet::Packet* packet = new inet::Packet(packetName.c_str());
+    const auto& payload = inet::makeShared<MqttSNConnAck>();
+    payload->setMsgType(MsgType::CONNACK);
+    payload->setReturnCode(ReturnCode::ACCEPTED);
+    payload->setAckBitmapFlag(true);
+    payload->setChunkLength(inet::B(payload->getLength()));
+
+    inet::Packet* packet = new inet::Packet("ConnAckPacket");
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNServer::sendMsgIdWithTopicIdPlus(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t topicId,
@@ -1038,7 +1200,7 @@ void MqttSNServer::sendMsgIdWithTopicIdPlus(const inet::L3Address& destAddress,
     inet::Packet* packet = PacketHelper::getMsgIdWithTopicIdPlusPacket(msgType, topicId, msgId, returnCode);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNServer::sendBaseWithMsgId(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t msgId)
@@ -1046,15 +1208,16 @@ void MqttSNServer::sendBaseWithMsgId(const inet::L3Address& destAddress, const i
     inet::Packet* packet = PacketHelper::getBaseWithMsgIdPacket(msgType, msgId);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNServer::sendSubAck(const inet::L3Address& destAddress, const int& destPort, QoS qosFlag, uint16_t topicId, uint16_t msgId,
-                              ReturnCode returnCode)
+                              ReturnCode returnCode, bool multicastFlag)
 {
     const auto& payload = inet::makeShared<MqttSNSubAck>();
     payload->setMsgType(MsgType::SUBACK);
     payload->setQoSFlag(qosFlag);
+    payload->setMulticastFlag(multicastFlag);
     payload->setTopicId(topicId);
     payload->setMsgId(msgId);
     payload->setReturnCode(returnCode);
@@ -1064,7 +1227,7 @@ void MqttSNServer::sendSubAck(const inet::L3Address& destAddress, const int& des
     packet->insertAtBack(payload);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNServer::sendRegister(const inet::L3Address& destAddress, const int& destPort, uint16_t topicId, uint16_t msgId,
@@ -1073,16 +1236,18 @@ void MqttSNServer::sendRegister(const inet::L3Address& destAddress, const int& d
     inet::Packet* packet = PacketHelper::getRegisterPacket(topicId, msgId, topicName);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNServer::sendPublish(const inet::L3Address& destAddress, const int& destPort, bool dupFlag, QoS qosFlag, bool retainFlag,
-                               TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const std::string& data, const TagInfo& tagInfo)
+                               TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const PayloadBuffer& data, const TagInfo& tagInfo,
+                               bool compressionFlag)
 {
-    inet::Packet* packet = PacketHelper::getPublishPacket(dupFlag, qosFlag, retainFlag, topicIdTypeFlag, topicId, msgId, data, tagInfo);
+    inet::Packet* packet = PacketHelper::getPublishPacket(dupFlag, qosFlag, retainFlag, topicIdTypeFlag, topicId, msgId, data, tagInfo,
+                                                          compressionFlag);
     MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
 
-    MqttSNApp::socket.sendTo(packet, destAddress, destPort);
+    MqttSNApp::sendPacket(packet, destAddress, destPort);
 }
 
 void MqttSNServer::handleAdvertiseEvent()
@@ -1092,60 +1257,54 @@ void MqttSNServer::handleAdvertiseEvent()
     scheduleClockEventAfter(advertiseInterval, advertiseEvent);
 }
 
-void MqttSNServer::handleActiveClientsCheckEvent()
+void MqttSNServer::handleClientsSupervisionEvent()
 {
-    for (auto it = clients.begin(); it != clients.end(); ++it) {
-        ClientInfo& clientInfo = it->second;
+    // visit only the clients whose supervision deadline has expired
+    while (!supervisionDeadlines.empty() && supervisionDeadlines.top().deadline <= getClockTime()) {
+        SupervisionDeadline supervisionDeadline = supervisionDeadlines.top();
+        supervisionDeadlines.pop();
 
-        // check if the client is ACTIVE and if the elapsed time from last received message is beyond the keep alive duration
-        if (clientInfo.currentState == ClientState::ACTIVE &&
-            (getClockTime() - clientInfo.lastReceivedMsgTime) > clientInfo.keepAliveDuration) {
+        ClientSlot* clientSlot = getClientSlot(supervisionDeadline.clientHandle);
+        if (clientSlot == nullptr) {
+            continue;
+        }
 
-            if (clientInfo.sentPingReq) {
-                // change the expired client state and activate the will feature
-                clientInfo.currentState = ClientState::LOST;
-                // will feature activation; to be implemented
-            }
-            else {
-                // send a solicitation ping request to the expired client
-                const std::pair<inet::L3Address, int> clientKey = it->first;
+        ClientInfo& clientInfo = clientSlot->clientInfo;
 
-                MqttSNApp::sendPingReq(clientKey.first, clientKey.second);
-                clientInfo.sentPingReq = true;
-            }
+        // skip outdated entries replaced by an earlier deadline
+        if (clientInfo.queuedSupervisionDeadline != supervisionDeadline.deadline) {
+            continue;
         }
-    }
-
-    scheduleClockEventAfter(activeClientsCheckInterval, activeClientsCheckEvent);
-}
 
-void MqttSNServer::handleAsleepClientsCheckEvent()
-{
-    for (auto it = clients.begin(); it != clients.end(); ++it) {
-        ClientInfo& clientInfo = it->second;
+        clientInfo.queuedSupervisionDeadline = 0;
 
-        // check if the client is ASLEEP and if the elapsed time from last received message is beyond the sleep duration
-        if (clientInfo.currentState == ClientState::ASLEEP &&
-            (getClockTime() - clientInfo.lastReceivedMsgTime) > clientInfo.sleepDuration) {
+        // the client is no longer supervised
+        if (clientInfo.supervisionDeadline == 0) {
+            continue;
+        }
 
-            // change the expired client state and activate the will feature
-            clientInfo.currentState = ClientState::LOST;
-            // will feature activation; to be implemented
+        // the client was refreshed in the meantime; queue it again for its current deadline
+        if (clientInfo.supervisionDeadline > getClockTime()) {
+            queueClientSupervision(supervisionDeadline.clientHandle, &clientInfo);
+            continue;
         }
+
+        expireClientSupervision(clientSlot, supervisionDeadline.clientHandle);
     }
 
-    scheduleClockEventAfter(asleepClientsCheckInterval, asleepClientsCheckEvent);
+    // arm the event for the next earliest deadline, if any
+    armClientsSupervisionEvent();
 }
 
 void MqttSNServer::handlePendingRetainCheckEvent()
 {
     for (auto it = pendingRetainMessages.begin(); it != pendingRetainMessages.end();) {
         // extract the information
-        std::pair<inet::L3Address, int> subscriber = it->first;
+        ClientSlot* clientSlot = getSubscriberClientSlot(it->first);
         const MessageInfo& messageInfo = it->second;
 
         // send the retained message to the subscriber with appropriate QoS
-        addAndSendPublishRequest(subscriber.first, subscriber.second, messageInfo, messageInfo.qos, 0, messageInfo.topicId);
+        addAndSendPublishRequest(clientSlot->clientAddress, clientSlot->clientPort, messageInfo, messageInfo.qos, 0, messageInfo.topicId);
 
         // remove the subscriber after sending the message
         it = pendingRetainMessages.erase(it);
@@ -1156,230 +1315,102 @@ void MqttSNServer::handlePendingRetainCheckEvent()
 
 void MqttSNServer::handleRequestsCheckEvent()
 {
-    // structure to store allocated objects for future deallocation
-    std::vector<MessageInfo*> allocatedObjects;
-
-    // iterate through the requests
-    for (auto requestIt = requests.begin(); requestIt != requests.end();) {
-        // find the same request ID in the set
-        auto requestIdIt = requestIds.find(requestIt->first);
-        if (requestIdIt == requestIds.end()) {
-            deleteRequest(requestIt, requestIdIt);
-            continue;
-        }
-
-        RequestInfo& requestInfo = requestIt->second;
-
-        // retrieve subscriber address and port
-        const inet::L3Address& subscriberAddress = requestInfo.subscriberAddress;
-        const int& subscriberPort = requestInfo.subscriberPort;
-
-        // get client information for the subscriber
-        ClientInfo* clientInfo = getSubscriberClientInfo(subscriberAddress, subscriberPort);
-
-        // check if the subscriber is in an ACTIVE or AWAKE state
-        if (clientInfo->currentState != ClientState::ACTIVE && clientInfo->currentState != ClientState::AWAKE) {
-            ++requestIt;
-            continue;
-        }
-
-        // get a message info pointer for regular or retained messages; memory allocation occurs for retained messages
-        MessageInfo* messageInfo = getRequestMessageInfo(requestInfo, allocatedObjects);
-
-        // check for an existing subscription
-        std::pair<uint16_t, QoS> subscriptionKey;
-        if (!findSubscription(subscriberAddress, subscriberPort, messageInfo->topicId, subscriptionKey)) {
-            deleteRequest(requestIt, requestIdIt);
-            continue;
-        }
-
-        // check if the subscriber is in the ACTIVE state and if the topic is registered for the subscriber
-        if (clientInfo->currentState == ClientState::ACTIVE &&
-            !isTopicRegisteredForSubscriber(subscriberAddress, subscriberPort, messageInfo->topicId)) {
-
-            // handle unregistered topic: initiate subscriber registration; the request will be processed later
-            manageRegistration(subscriberAddress, subscriberPort, messageInfo->topicId);
+    // iterate through the subscribers that have sendable work
+    for (uint32_t subscriberHandle : readySubscribers) {
+        ClientSlot* clientSlot = getSubscriberClientSlot(subscriberHandle);
+        ClientState subscriberState = clientSlot->clientInfo.currentState;
 
-            ++requestIt;
-            continue;
+        // process the subscriber queue only if the subscriber is in an ACTIVE or AWAKE state
+        if (subscriberState == ClientState::ACTIVE || subscriberState == ClientState::AWAKE) {
+            processSubscriberRequests(clientSlot);
         }
+    }
 
-        QoS resultQoS;
-
-        if (requestInfo.messageType == MsgType::PUBLISH) {
-            // calculate the minimum QoS level between subscription QoS and original publish QoS
-            resultQoS = NumericHelper::minQoS(subscriptionKey.second, messageInfo->qos);
-
-            if (resultQoS == QoS::QOS_MINUS_ONE || resultQoS == QoS::QOS_ZERO) {
-                // send a publish message with QoS -1 or QoS 0 to the subscriber
-                sendPublish(subscriberAddress, subscriberPort, messageInfo->dup, resultQoS, messageInfo->retain,
-                            messageInfo->topicIdType, messageInfo->topicId, 0, messageInfo->data, messageInfo->tagInfo);
-
-                deleteRequest(requestIt, requestIdIt);
-                continue;
-            }
-
-            if (requestInfo.sendAtLeastOnce) {
-                // send a publish message with QoS 1 or QoS 2 to the subscriber
-                sendPublish(subscriberAddress, subscriberPort, messageInfo->dup, resultQoS, messageInfo->retain,
-                            messageInfo->topicIdType, messageInfo->topicId, requestIt->first, messageInfo->data, messageInfo->tagInfo);
+    // sent requests are now tracked by their deadlines; a wake-up, a new request or a registration ACK marks the subscriber again
+    readySubscribers.clear();
+}
 
-                // update request information
-                requestInfo.sendAtLeastOnce = false;
-                requestInfo.requestTime = getClockTime();
+void MqttSNServer::handleRetransmissionEvent()
+{
+    // visit only the entries whose deadline has expired
+    while (!retransmissionDeadlines.empty() && retransmissionDeadlines.top().deadline <= getClockTime()) {
+        RetransmissionDeadline retransmissionDeadline = retransmissionDeadlines.top();
+        retransmissionDeadlines.pop();
 
-                ++requestIt;
-                continue;
-            }
+        if (retransmissionDeadline.isRegistration) {
+            handleRegistrationDeadline(retransmissionDeadline);
         }
-
-        // check if the elapsed time from last received message is beyond the retransmission duration
-        if ((getClockTime() - requestInfo.requestTime) > MqttSNApp::retransmissionInterval) {
-            // check if the number of retries equals the threshold
-            if (requestInfo.retransmissionCounter >= MqttSNApp::retransmissionCounter) {
-                deleteRequest(requestIt, requestIdIt);
-                continue;
-            }
-
-            resultQoS = NumericHelper::minQoS(subscriptionKey.second, messageInfo->qos);
-
-            if (requestInfo.messageType == MsgType::PUBLISH) {
-                // send a publish message with QoS 1 or QoS 2 to the subscriber
-                sendPublish(subscriberAddress, subscriberPort, true, resultQoS, messageInfo->retain,
-                            messageInfo->topicIdType, messageInfo->topicId, requestIt->first, messageInfo->data, messageInfo->tagInfo);
-            }
-            else if (requestInfo.messageType == MsgType::PUBREL) {
-                // send publish release
-                sendBaseWithMsgId(subscriberAddress, subscriberPort, MsgType::PUBREL, requestIt->first);
-            }
-
-            // update request information
-            requestInfo.retransmissionCounter++;
-            requestInfo.requestTime = getClockTime();
-
-            MqttSNApp::serversRetransmissions++;
+        else {
+            handleRequestDeadline(retransmissionDeadline);
         }
-
-        ++requestIt;
     }
 
-    // deallocate objects
-    deleteAllocatedMessages(allocatedObjects);
-
-    scheduleClockEventAfter(requestsCheckInterval, requestsCheckEvent);
+    // arm the event for the next earliest deadline, if any
+    armRetransmissionEvent();
 }
 
-void MqttSNServer::handleRegistrationsCheckEvent()
+void MqttSNServer::handleAckBitmapEvent()
 {
-    // iterate through the registrations
-    for (auto registrationIt = registrations.begin(); registrationIt != registrations.end();) {
-        // find the same registration ID in the set
-        auto registrationIdIt = registrationIds.find(registrationIt->first);
-        if (registrationIdIt == registrationIds.end()) {
-            deleteRegistration(registrationIt, registrationIdIt);
-            continue;
-        }
-
-        RegisterInfo& registerInfo = registrationIt->second;
-
-        // check if the elapsed time from last received message is beyond the retransmission duration
-        if ((getClockTime() - registerInfo.requestTime) > MqttSNApp::retransmissionInterval) {
-            // check if the number of retries equals the threshold
-            if (registerInfo.retransmissionCounter >= MqttSNApp::retransmissionCounter) {
-                deleteRegistration(registrationIt, registrationIdIt);
-                continue;
-            }
+    // visit only the batches whose hold time has expired
+    while (!ackBitmapDeadlines.empty() && ackBitmapDeadlines.front().deadline <= getClockTime()) {
+        SupervisionDeadline ackBitmapDeadline = ackBitmapDeadlines.front();
+        ackBitmapDeadlines.pop();
 
-            sendRegister(registerInfo.subscriberAddress, registerInfo.subscriberPort, registerInfo.topicId,
-                         registrationIt->first, registerInfo.topicName);
+        ClientSlot* clientSlot = getClientSlot(ackBitmapDeadline.clientHandle);
 
-            // update the registration
-            registerInfo.retransmissionCounter++;
-            registerInfo.requestTime = getClockTime();
+        // skip entries of batches flushed early or of removed publishers
+        if (clientSlot == nullptr || !clientSlot->isPublisher ||
+            clientSlot->publisherInfo.ackBitmapDeadline != ackBitmapDeadline.deadline) {
 
-            MqttSNApp::serversRetransmissions++;
+            continue;
         }
 
-        ++registrationIt;
+        flushAckBitmap(clientSlot);
     }
 
-    scheduleClockEventAfter(registrationsCheckInterval, registrationsCheckEvent);
+    // arm the event for the next earliest deadline, if any
+    armAckBitmapEvent();
 }
 
 void MqttSNServer::handleAwakenSubscriberCheckEvent(omnetpp::cMessage* msg)
 {
-    // extract subscriber address and port from the message
-    inet::L3Address subscriberAddress = inet::L3Address(msg->par("subscriberAddress").stringValue());
-    int subscriberPort = msg->par("subscriberPort").longValue();
-
-    std::pair<inet::L3Address, int> key = std::make_pair(subscriberAddress, subscriberPort);
+    // extract the subscriber handle from the message
+    uint32_t subscriberHandle = msg->par("subscriberHandle").longValue();
 
     // search for the subscriber in the structure
-    auto it = subscribers.find(key);
-    if (it == subscribers.end()) {
+    ClientSlot* clientSlot = getClientSlot(subscriberHandle);
+    if (clientSlot == nullptr || !clientSlot->isSubscriber) {
         throw omnetpp::cRuntimeError("Subscriber not found while processing the check event");
     }
 
-    SubscriberInfo& subscriberInfo = it->second;
+    SubscriberInfo& subscriberInfo = clientSlot->subscriberInfo;
 
-    // check if the elapsed time since the start of the scheduled event is within the threshold
+    // check if the elapsed time since the start of the scheduled event is within the threshold; with adaptive
+    // retransmission the backoff may exceed TRETRY, so an in-flight request keeps the window open until its deadline
     if ((getClockTime() - subscriberInfo.awakenSubscriberCheckStartTime) <=
-        MqttSNApp::retransmissionCounter * MqttSNApp::retransmissionInterval) {
+        MqttSNApp::retransmissionCounter * MqttSNApp::retransmissionInterval ||
+        getClockTime() <= getLatestRequestDeadline(&subscriberInfo)) {
 
-        // search if there is at least one pending request for the subscriber in AWAKE state
-        for (const auto& request : requests) {
-            if (request.second.subscriberAddress == subscriberAddress && request.second.subscriberPort == subscriberPort) {
-                // if there is a pending request, reschedule and check again next time
-                scheduleClockEventAfter(awakenSubscriberCheckInterval, subscriberInfo.awakenSubscriberCheckEvent);
-                return;
-            }
+        // check if there is at least one pending request for the subscriber in AWAKE state
+        if (!subscriberInfo.requestIds.empty()) {
+            // if there is a pending request, reschedule and check again next time
+            scheduleClockEventAfter(awakenSubscriberCheckInterval, subscriberInfo.awakenSubscriberCheckEvent);
+            return;
         }
     }
 
     // no pending requests found for the subscriber; set its state to ASLEEP and respond with PINGRESP
-    ClientInfo* clientInfo = getSubscriberClientInfo(subscriberAddress, subscriberPort);
-    clientInfo->currentState = ClientState::ASLEEP;
+    updateClientState(subscriberHandle, &clientSlot->clientInfo, ClientState::ASLEEP);
+    updateClientSupervision(subscriberHandle, &clientSlot->clientInfo);
 
     // send PINGRESP message to the subscriber
-    MqttSNApp::sendBase(subscriberAddress, subscriberPort, MsgType::PINGRESP);
+    MqttSNApp::sendBase(clientSlot->clientAddress, clientSlot->clientPort, MsgType::PINGRESP);
 
     // deallocate clock event object
     delete subscriberInfo.awakenSubscriberCheckEvent;
     subscriberInfo.awakenSubscriberCheckEvent = nullptr;
 }
 
-void MqttSNServer::handleMessagesClearEvent()
-{
-    // iterate through messages
-    for (auto messageIt = messages.begin(); messageIt != messages.end();) {
-        // find the same message ID in the set
-        auto messageIdIt = messageIds.find(messageIt->first);
-        if (messageIdIt == messageIds.end()) {
-            throw omnetpp::cRuntimeError("Mismatch between message structures during message clearance");
-        }
-
-        bool isUsed = false;
-
-        // check if the message is used in at least one request
-        for (auto requestIt = requests.begin(); requestIt != requests.end(); ++requestIt) {
-            if (requestIt->second.messagesKey == messageIt->first) {
-                isUsed = true;
-                break;
-            }
-        }
-
-        // if the message is not used, remove it
-        if (!isUsed) {
-            deleteMessage(messageIt, messageIdIt);
-            continue;
-        }
-
-        ++messageIt;
-    }
-
-    scheduleClockEventAfter(messagesClearInterval, messagesClearEvent);
-}
-
 void MqttSNServer::cleanClientSession(const inet::L3Address& clientAddress, const int& clientPort, ClientType clientType)
 {
     if (clientType == ClientType::PUBLISHER) {
@@ -1404,9 +1435,10 @@ void MqttSNServer::cleanClientSession(const inet::L3Address& clientAddress, cons
         throw omnetpp::cRuntimeError("Subscriber not found during the clean session operation");
     }
 
-    // delete all subscriptions for the subscriber
-    for (auto& topic : subscriberInfo->subscriberTopics) {
-        deleteSubscriptionIfExists(clientAddress, clientPort, topic.first);
+    // delete all subscriptions for the subscriber; advance before erasing the current topic
+    for (auto it = subscriberInfo->subscriberTopics.begin(); it != subscriberInfo->subscriberTopics.end();) {
+        uint16_t topicId = (it++)->first;
+        deleteSubscriptionIfExists(clientAddress, clientPort, topicId);
     }
 }
 
@@ -1418,100 +1450,210 @@ void MqttSNServer::updateClientType(ClientInfo* clientInfo, ClientType clientTyp
     }
 }
 
+void MqttSNServer::updateClientState(uint32_t clientHandle, ClientInfo* clientInfo, ClientState clientState)
+{
+    if (clientInfo->currentState == clientState) {
+        return;
+    }
+
+    // keep the running count used for the load hint
+    connectedClients += isConnectedState(clientState);
+    connectedClients -= isConnectedState(clientInfo->currentState);
+
+    clientInfo->currentState = clientState;
+
+    // the subscriber may have become reachable or unreachable for QoS -1 publications
+    ClientSlot* clientSlot = getClientSlot(clientHandle);
+    if (clientSlot != nullptr && clientSlot->isSubscriber) {
+        updateMinusOneRoutes(clientHandle);
+    }
+}
+
+bool MqttSNServer::isConnectedState(ClientState clientState)
+{
+    return clientState == ClientState::ACTIVE || clientState == ClientState::ASLEEP || clientState == ClientState::AWAKE;
+}
+
 ClientInfo* MqttSNServer::addNewClient(const inet::L3Address& clientAddress, const int& clientPort)
 {
-    // create a pair for client address and port
-    std::pair<inet::L3Address, int> clientKey = std::make_pair(clientAddress, clientPort);
+    // growing past the reserved storage would invalidate the slot pointers held by callers
+    if (clientSlots.size() >= clientSlots.capacity()) {
+        throw omnetpp::cRuntimeError("Failed to assign a new client slot. All reserved client slots are in use");
+    }
+
+    // insert a new default client slot
+    ClientSlot clientSlot;
+    clientSlot.clientAddress = clientAddress;
+    clientSlot.clientPort = clientPort;
+
+    clientSlots.push_back(clientSlot);
 
-    // insert a new default client
-    ClientInfo clientInfo;
-    clients[clientKey] = clientInfo;
+    // index the slot by the client transport address; handles are the slot index plus one
+    clientHandles[std::make_pair(clientAddress, clientPort)] = clientSlots.size();
 
-    return &clients[clientKey];
+    return &clientSlots.back().clientInfo;
 }
 
 ClientInfo* MqttSNServer::getClientInfo(const inet::L3Address& clientAddress, const int& clientPort)
 {
     // check if the client with the specified address and port is present in the data structure
-    auto clientIterator = clients.find(std::make_pair(clientAddress, clientPort));
+    return getClientInfo(getClientHandle(clientAddress, clientPort));
+}
+
+ClientInfo* MqttSNServer::getClientInfo(uint32_t clientHandle)
+{
+    ClientSlot* clientSlot = getClientSlot(clientHandle);
 
-    if (clientIterator != clients.end()) {
-        return &clientIterator->second;
+    if (clientSlot != nullptr) {
+        return &clientSlot->clientInfo;
     }
 
     return nullptr;
 }
 
+uint32_t MqttSNServer::getClientHandle(const inet::L3Address& clientAddress, const int& clientPort)
+{
+    auto it = clientHandles.find(std::make_pair(clientAddress, clientPort));
+    if (it == clientHandles.end()) {
+        return INVALID_CLIENT_HANDLE;
+    }
+
+    return it->second;
+}
+
+ClientSlot* MqttSNServer::getClientSlot(uint32_t clientHandle)
+{
+    // reject the invalid handle and handles pointing outside the table
+    if (clientHandle == INVALID_CLIENT_HANDLE || clientHandle > clientSlots.size()) {
+        return nullptr;
+    }
+
+    return &clientSlots[clientHandle - 1];
+}
+
 PublisherInfo* MqttSNServer::getPublisherInfo(const inet::L3Address& publisherAddress, const int& publisherPort, bool insertIfNotFound)
 {
-    // create a pair for publisher address and port
-    std::pair<inet::L3Address, int> publisherKey = std::make_pair(publisherAddress, publisherPort);
+    // check if the client with the specified address and port is present in the data structure
+    ClientSlot* clientSlot = getClientSlot(getClientHandle(publisherAddress, publisherPort));
+
+    if (clientSlot == nullptr) {
+        if (insertIfNotFound) {
+            throw omnetpp::cRuntimeError("Client not found while adding publisher information");
+        }
 
-    // check if the publisher with the specified address and port is present in the data structure
-    auto publisherIterator = publishers.find(publisherKey);
+        return nullptr;
+    }
 
-    if (publisherIterator != publishers.end()) {
-        return &publisherIterator->second;
+    if (clientSlot->isPublisher) {
+        return &clientSlot->publisherInfo;
     }
 
     if (insertIfNotFound) {
-        // insert a new default publisher
-        PublisherInfo publisherInfo;
-        publishers[publisherKey] = publisherInfo;
+        // mark the slot as publisher with default publisher information
+        clientSlot->isPublisher = true;
+        clientSlot->publisherInfo = PublisherInfo();
 
-        return &publishers[publisherKey];
+        return &clientSlot->publisherInfo;
     }
 
     return nullptr;
 }
 
-void MqttSNServer::fillWithPredefinedTopics()
+void MqttSNServer::addPubAckToBitmap(uint32_t publisherHandle, PublisherInfo* publisherInfo, uint16_t msgId)
 {
-    // retrieve predefined topics and their IDs
-    std::map<std::string, uint16_t> predefinedTopics = MqttSNApp::getPredefinedTopics();
+    ClientSlot* clientSlot = getClientSlot(publisherHandle);
+    AckBitmapAccumulator& ackBitmap = publisherInfo->ackBitmap;
 
-    for (const auto& topic : predefinedTopics) {
-        addNewTopic(topic.first, topic.second, TopicIdType::PRE_DEFINED_TOPIC_ID);
+    // flush first if the message ID falls outside the window following the base
+    if (!ackBitmap.isEmpty() && !ackBitmap.fits(msgId)) {
+        flushAckBitmap(clientSlot);
     }
-}
 
-void MqttSNServer::addNewTopic(const std::string& topicName, uint16_t topicId, TopicIdType topicIdType)
-{
-    TopicInfo topicInfo;
-    topicInfo.topicName = topicName;
-    topicInfo.topicIdType = topicIdType;
+    if (ackBitmap.isEmpty()) {
+        ackBitmap.add(msgId);
+        publisherInfo->ackBitmapDeadline = getClockTime() + ackBitmapWindow;
 
-    // add the new topic in the data structures
-    topicsToIds[topicName] = topicId;
-    idsToTopics[topicId] = topicInfo;
-    topicIds.insert(topicId);
-}
+        SupervisionDeadline ackBitmapDeadline;
+        ackBitmapDeadline.deadline = publisherInfo->ackBitmapDeadline;
+        ackBitmapDeadline.clientHandle = publisherHandle;
 
-void MqttSNServer::checkTopicsToIds(const std::string& topicName, uint16_t topicId)
-{
-    if (topicId != getTopicByName(topicName)) {
-        throw omnetpp::cRuntimeError("Mismatch in topic IDs");
+        ackBitmapDeadlines.push(ackBitmapDeadline);
+        armAckBitmapEvent();
+        return;
+    }
+
+    ackBitmap.add(msgId);
+
+    if (ackBitmap.isFull()) {
+        flushAckBitmap(clientSlot);
     }
 }
 
-uint16_t MqttSNServer::getTopicByName(const std::string& topicName)
+void MqttSNServer::flushAckBitmap(ClientSlot* clientSlot)
 {
-    auto it = topicsToIds.find(topicName);
-    if (it == topicsToIds.end()) {
-        throw omnetpp::cRuntimeError("Topic name not found in the structure");
+    PublisherInfo& publisherInfo = clientSlot->publisherInfo;
+
+    if (publisherInfo.ackBitmap.isEmpty()) {
+        return;
     }
 
-    return it->second;
+    // a publisher that left in the meantime retransmits after reconnecting
+    if (clientSlot->clientInfo.currentState == ClientState::ACTIVE) {
+        sendAckBitmap(clientSlot->clientAddress, clientSlot->clientPort, publisherInfo.ackBitmap.getBaseMsgId(),
+                      publisherInfo.ackBitmap.getMask());
+    }
+
+    // a pending deadline entry no longer matches and is skipped
+    publisherInfo.ackBitmap.clear();
+    publisherInfo.ackBitmapDeadline = 0;
 }
 
-TopicInfo MqttSNServer::getTopicById(uint16_t topicId)
+void MqttSNServer::armAckBitmapEvent()
 {
-    auto it = idsToTopics.find(topicId);
-    if (it == idsToTopics.end()) {
-        throw omnetpp::cRuntimeError("Topic ID not found in the structure");
+    // nothing to arm without pending batches
+    if (ackBitmapDeadlines.empty()) {
+        return;
     }
 
-    return it->second;
+    inet::clocktime_t earliestDeadline = std::max(ackBitmapDeadlines.front().deadline, getClockTime());
+
+    if (ackBitmapEvent->isScheduled()) {
+        // keep the event if it already fires no later than the earliest deadline
+        if (ackBitmapEvent->getArrivalClockTime() <= earliestDeadline) {
+            return;
+        }
+
+        cancelEvent(ackBitmapEvent);
+    }
+
+    scheduleClockEventAt(earliestDeadline, ackBitmapEvent);
+}
+
+void MqttSNServer::fillWithPredefinedTopics()
+{
+    // intern predefined topics and their IDs directly in the topic registry
+    MqttSNApp::getPredefinedTopics(topicRegistry);
+
+    TopicInfo topicInfo;
+    topicInfo.topicIdType = TopicIdType::PRE_DEFINED_TOPIC_ID;
+
+    // track type and ID usage of predefined topics as for any other topic
+    for (const auto& topic : topicRegistry) {
+        idsToTopics[topic.second] = topicInfo;
+        topicIds.reserve(topic.second);
+    }
+}
+
+void MqttSNServer::addNewTopic(const std::string& topicName, uint16_t topicId, TopicIdType topicIdType)
+{
+    TopicInfo topicInfo;
+    topicInfo.topicIdType = topicIdType;
+    topicInfo.multicast = MqttSNApp::isMulticastEnabled() && (multicastTopics.empty() || multicastTopics.count(topicName) > 0);
+
+    // intern the topic name and add the new topic in the data structures
+    topicRegistry.insert(topicName, topicId);
+    idsToTopics[topicId] = topicInfo;
+    topicIds.reserve(topicId);
 }
 
 TopicIdType MqttSNServer::getTopicIdType(uint16_t topicLength)
@@ -1526,17 +1668,20 @@ TopicIdType MqttSNServer::getTopicIdType(uint16_t topicLength)
     throw omnetpp::cRuntimeError("Invalid topic length");
 }
 
-void MqttSNServer::addNewRetainMessage(uint16_t topicId, bool dup, QoS qos, TopicIdType topicIdType, const std::string& data)
+void MqttSNServer::addNewRetainMessage(uint16_t topicId, bool dup, QoS qos, TopicIdType topicIdType, const PayloadBuffer& data, bool compressed)
 {
-    // store message as retained for the topic
-    RetainMessageInfo retainMessageInfo;
+    // store message as retained for the topic; requests point at it directly
+    MessageInfo retainMessageInfo;
+    retainMessageInfo.topicId = topicId;
+    retainMessageInfo.topicIdType = topicIdType;
     retainMessageInfo.dup = dup;
     retainMessageInfo.qos = qos;
-    retainMessageInfo.topicIdType = topicIdType;
+    retainMessageInfo.retain = true;
     retainMessageInfo.data = data;
+    retainMessageInfo.compressed = compressed;
 
     retainMessages[topicId] = retainMessageInfo;
-    retainMessageIds.insert(topicId);
+    retainMessageIds.reserve(topicId);
 }
 
 void MqttSNServer::addNewPendingRetainMessage(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId, QoS qos)
@@ -1544,21 +1689,14 @@ void MqttSNServer::addNewPendingRetainMessage(const inet::L3Address& subscriberA
     // check for retained message on the subscribed topic
     auto retainMsgIt = retainMessages.find(topicId);
     if (retainMsgIt != retainMessages.end()) {
-        // retrieve retained message information
-        const RetainMessageInfo& retainMessageInfo = retainMsgIt->second;
-
-        MessageInfo messageInfo;
-        messageInfo.topicId = topicId;
-        messageInfo.topicIdType = retainMessageInfo.topicIdType;
-        messageInfo.dup = retainMessageInfo.dup;
-        messageInfo.retain = true;
-        messageInfo.data = retainMessageInfo.data;
+        // copy the retained message; the payload buffer is shared
+        MessageInfo messageInfo = retainMsgIt->second;
 
         // calculate the minimum QoS level between subscription QoS and original publish QoS
-        messageInfo.qos = NumericHelper::minQoS(qos, retainMessageInfo.qos);
+        messageInfo.qos = NumericHelper::minQoS(qos, messageInfo.qos);
 
         // store the pending retain message for the subscriber
-        pendingRetainMessages[std::make_pair(subscriberAddress, subscriberPort)] = messageInfo;
+        pendingRetainMessages[getClientHandle(subscriberAddress, subscriberPort)] = messageInfo;
     }
 }
 
@@ -1568,9 +1706,8 @@ void MqttSNServer::addNewMessage(const MessageInfo& messageInfo)
     MqttSNApp::getNewIdentifier(messageIds, currentMessageId,
                                 "Failed to assign a new message ID. All available message IDs are in use");
 
-    // add the new message in the data structures
+    // add the new message in the data structure
     messages[currentMessageId] = messageInfo;
-    messageIds.insert(currentMessageId);
 }
 
 void MqttSNServer::addAndMarkMessage(const MessageInfo& messageInfo, bool& isMessageAdded)
@@ -1579,24 +1716,39 @@ void MqttSNServer::addAndMarkMessage(const MessageInfo& messageInfo, bool& isMes
     isMessageAdded = true;
 }
 
-void MqttSNServer::deleteMessage(std::map<uint16_t, MessageInfo>::iterator& messageIt, std::set<uint16_t>::iterator& messageIdIt)
+void MqttSNServer::deleteMessage(std::map<uint16_t, MessageInfo>::iterator& messageIt)
 {
-    // remove the message from both structures
+    // release the message ID and remove the message
+    messageIds.release(messageIt->first);
     messageIt = messages.erase(messageIt);
-    messageIdIt = messageIds.erase(messageIdIt);
 }
 
-void MqttSNServer::deleteAllocatedMessages(const std::vector<MessageInfo*>& messages)
+void MqttSNServer::addMessageReference(uint16_t messageId)
+{
+    auto messageIt = messages.find(messageId);
+    if (messageIt == messages.end()) {
+        throw omnetpp::cRuntimeError("Message not found while adding a reference");
+    }
+
+    messageIt->second.referenceCounter++;
+}
+
+void MqttSNServer::releaseMessageReference(uint16_t messageId)
 {
-    // delete objects pointed to by the pointers in the vector
-    for (auto message : messages) {
-        delete message;
+    auto messageIt = messages.find(messageId);
+    if (messageIt == messages.end()) {
+        throw omnetpp::cRuntimeError("Message not found while releasing a reference");
+    }
+
+    // delete the message as soon as no request references it anymore
+    if (--messageIt->second.referenceCounter <= 0) {
+        deleteMessage(messageIt);
     }
 }
 
-MessageInfo* MqttSNServer::getRequestMessageInfo(const RequestInfo& requestInfo, std::vector<MessageInfo*>& allocatedObjects)
+const MessageInfo* MqttSNServer::getRequestMessageInfo(const RequestInfo& requestInfo)
 {
-    MessageInfo* messageInfo = nullptr;
+    const MessageInfo* messageInfo = nullptr;
 
     if (requestInfo.messagesKey > 0) {
         // check if the key exists in the messages map
@@ -1609,21 +1761,7 @@ MessageInfo* MqttSNServer::getRequestMessageInfo(const RequestInfo& requestInfo,
         // check if the key exists in the retain messages map
         auto retainMessageIt = retainMessages.find(requestInfo.retainMessagesKey);
         if (retainMessageIt != retainMessages.end()) {
-            const RetainMessageInfo& retainMessageInfo = retainMessageIt->second;
-
-            // allocate memory for a new object
-            messageInfo = new MessageInfo;
-
-            // populate the fields of the new object
-            messageInfo->topicId = requestInfo.retainMessagesKey;
-            messageInfo->topicIdType = retainMessageInfo.topicIdType;
-            messageInfo->dup = retainMessageInfo.dup;
-            messageInfo->qos = retainMessageInfo.qos;
-            messageInfo->retain = true;
-            messageInfo->data = retainMessageInfo.data;
-
-            // add the object pointer to the vector for future deallocation
-            allocatedObjects.push_back(messageInfo);
+            messageInfo = &retainMessageIt->second;
         }
     }
     else {
@@ -1633,52 +1771,229 @@ MessageInfo* MqttSNServer::getRequestMessageInfo(const RequestInfo& requestInfo,
     return messageInfo;
 }
 
+void MqttSNServer::processSubscriberRequests(ClientSlot* clientSlot)
+{
+    // retrieve subscriber address, port and state
+    const inet::L3Address& subscriberAddress = clientSlot->clientAddress;
+    const int& subscriberPort = clientSlot->clientPort;
+    ClientInfo* clientInfo = &clientSlot->clientInfo;
+
+    std::set<uint16_t>& subscriberRequestIds = clientSlot->subscriberInfo.requestIds;
+
+    // iterate through the subscriber queue; advance before a request can be deleted
+    for (auto queueIt = subscriberRequestIds.begin(); queueIt != subscriberRequestIds.end();) {
+        uint16_t requestId = *queueIt++;
+
+        auto requestIt = requests.find(requestId);
+        if (requestIt == requests.end()) {
+            throw omnetpp::cRuntimeError("Mismatch between request structures during subscriber queue processing");
+        }
+
+        RequestInfo& requestInfo = requestIt->second;
+
+        // get a message info pointer for regular or retained messages
+        const MessageInfo* messageInfo = getRequestMessageInfo(requestInfo);
+
+        // check for an existing subscription
+        QoS subscriptionQoS;
+        if (!findSubscription(subscriberAddress, subscriberPort, messageInfo->topicId, subscriptionQoS)) {
+            deleteRequest(requestIt);
+            continue;
+        }
+
+        // check if the subscriber is in the ACTIVE state and if the topic is registered for the subscriber
+        if (clientInfo->currentState == ClientState::ACTIVE &&
+            !isTopicRegisteredForSubscriber(subscriberAddress, subscriberPort, messageInfo->topicId)) {
+
+            // handle unregistered topic: initiate subscriber registration; the request will be processed later
+            manageRegistration(subscriberAddress, subscriberPort, messageInfo->topicId);
+            continue;
+        }
+
+        QoS resultQoS;
+
+        if (requestInfo.messageType == MsgType::PUBLISH) {
+            // calculate the minimum QoS level between subscription QoS and original publish QoS
+            resultQoS = NumericHelper::minQoS(subscriptionQoS, messageInfo->qos);
+
+            if (resultQoS == QoS::QOS_MINUS_ONE || resultQoS == QoS::QOS_ZERO) {
+                // send a publish message with QoS -1 or QoS 0 to the subscriber
+                sendPublish(subscriberAddress, subscriberPort, messageInfo->dup, resultQoS, messageInfo->retain,
+                            messageInfo->topicIdType, messageInfo->topicId, 0, messageInfo->data, messageInfo->tagInfo,
+                            messageInfo->compressed);
+
+                deleteRequest(requestIt);
+                continue;
+            }
+
+            if (requestInfo.sendAtLeastOnce) {
+                // send a publish message with QoS 1 or QoS 2 to the subscriber
+                sendPublish(subscriberAddress, subscriberPort, messageInfo->dup, resultQoS, messageInfo->retain,
+                            messageInfo->topicIdType, messageInfo->topicId, requestId, messageInfo->data, messageInfo->tagInfo,
+                            messageInfo->compressed);
+
+                // update request information
+                requestInfo.sendAtLeastOnce = false;
+                requestInfo.requestTime = getClockTime();
+                requestInfo.deadline = requestInfo.requestTime + MqttSNApp::getRetransmissionTimeout(subscriberAddress, subscriberPort, 0);
+
+                addRetransmissionDeadline(requestInfo.deadline, false, requestId);
+                continue;
+            }
+        }
+
+        // retransmit requests whose deadline expired while the subscriber could not receive
+        if (getClockTime() >= requestInfo.deadline) {
+            retransmitRequest(clientSlot, requestIt, messageInfo, subscriptionQoS);
+        }
+    }
+}
+
+void MqttSNServer::retransmitRequest(ClientSlot* clientSlot, std::map<uint16_t, RequestInfo>::iterator& requestIt,
+                                     const MessageInfo* messageInfo, QoS subscriptionQoS)
+{
+    RequestInfo& requestInfo = requestIt->second;
+
+    // check if the number of retries equals the threshold
+    if (requestInfo.retransmissionCounter >= MqttSNApp::retransmissionCounter) {
+        deleteRequest(requestIt);
+        return;
+    }
+
+    if (requestInfo.messageType == MsgType::PUBLISH) {
+        // send a publish message with QoS 1 or QoS 2 to the subscriber
+        sendPublish(clientSlot->clientAddress, clientSlot->clientPort, true, NumericHelper::minQoS(subscriptionQoS, messageInfo->qos),
+                    messageInfo->retain, messageInfo->topicIdType, messageInfo->topicId, requestIt->first, messageInfo->data,
+                    messageInfo->tagInfo, messageInfo->compressed);
+    }
+    else if (requestInfo.messageType == MsgType::PUBREL) {
+        // send publish release
+        sendBaseWithMsgId(clientSlot->clientAddress, clientSlot->clientPort, MsgType::PUBREL, requestIt->first);
+    }
+
+    // update request information
+    requestInfo.retransmissionCounter++;
+    requestInfo.requestTime = getClockTime();
+    requestInfo.deadline = requestInfo.requestTime + MqttSNApp::getRetransmissionTimeout(clientSlot->clientAddress, clientSlot->clientPort,
+                                                                                          requestInfo.retransmissionCounter);
+
+    addRetransmissionDeadline(requestInfo.deadline, false, requestIt->first);
+
+    MqttSNApp::serversRetransmissions++;
+}
+
+void MqttSNServer::handleRequestDeadline(const RetransmissionDeadline& retransmissionDeadline)
+{
+    uint16_t requestId = retransmissionDeadline.id;
+
+    auto requestIt = requests.find(requestId);
+    if (requestIt == requests.end()) {
+        // the request was acknowledged or dropped in the meantime
+        return;
+    }
+
+    RequestInfo& requestInfo = requestIt->second;
+
+    // skip outdated deadlines of requests that were sent again or are still waiting for their first send
+    if (requestInfo.sendAtLeastOnce || requestInfo.deadline != retransmissionDeadline.deadline) {
+        return;
+    }
+
+    ClientSlot* clientSlot = getSubscriberClientSlot(requestInfo.subscriberHandle);
+    ClientState subscriberState = clientSlot->clientInfo.currentState;
+
+    // defer the retransmission until the subscriber can receive again; its queue is processed on wake-up
+    if (subscriberState != ClientState::ACTIVE && subscriberState != ClientState::AWAKE) {
+        return;
+    }
+
+    // get a message info pointer for regular or retained messages
+    const MessageInfo* messageInfo = getRequestMessageInfo(requestInfo);
+
+    // check for an existing subscription
+    QoS subscriptionQoS;
+    if (!findSubscription(clientSlot->clientAddress, clientSlot->clientPort, messageInfo->topicId, subscriptionQoS)) {
+        deleteRequest(requestIt);
+        return;
+    }
+
+    // a reconnected subscriber may have lost the topic registration; register first and retransmit once acknowledged
+    if (subscriberState == ClientState::ACTIVE &&
+        !isTopicRegisteredForSubscriber(clientSlot->clientAddress, clientSlot->clientPort, messageInfo->topicId)) {
+
+        manageRegistration(clientSlot->clientAddress, clientSlot->clientPort, messageInfo->topicId);
+        return;
+    }
+
+    retransmitRequest(clientSlot, requestIt, messageInfo, subscriptionQoS);
+}
+
 void MqttSNServer::dispatchPublishToSubscribers(const MessageInfo& messageInfo)
 {
     // set to track whether a new message needs to be added
     bool isMessageAdded = false;
 
-    // keys with the same topic ID
-    std::set<std::pair<uint16_t, QoS>> keys = getSubscriptionKeysByTopicId(messageInfo.topicId);
-
-    // iterate for each QoS
-    for (const auto& key : keys) {
-        // check if the subscription exists for the given key
-        auto subscriptionIt = subscriptions.find(key);
-        if (subscriptionIt != subscriptions.end()) {
-            // calculate the minimum QoS level between subscription QoS and incoming publish QoS
-            QoS resultQoS = NumericHelper::minQoS(key.second, messageInfo.qos);
-
-            for (const auto& subscriber : subscriptionIt->second) {
-                // retrieve subscriber address and port
-                const inet::L3Address& subscriberAddress = subscriber.first;
-                const int& subscriberPort = subscriber.second;
-
-                // get client information for the subscriber
-                ClientInfo* clientInfo = getSubscriberClientInfo(subscriberAddress, subscriberPort);
-
-                // check subscriber state and handle accordingly
-                switch (clientInfo->currentState) {
-                    case ClientState::ACTIVE:
-                        // check if the subscriber is registered for the topic and take appropriate action
-                        processRequestForActiveSubscriber(subscriberAddress, subscriberPort, messageInfo, resultQoS, isMessageAdded);
-                        break;
-
-                    case ClientState::AWAKE:
-                        // registered topic; send request directly, keeping only QoS 1 and 2 requests
-                        processRequest(subscriberAddress, subscriberPort, messageInfo, resultQoS, isMessageAdded);
-                        break;
-
-                    case ClientState::ASLEEP:
-                        // keep the request to be processed later
-                        bufferRequest(subscriberAddress, subscriberPort, messageInfo, isMessageAdded);
-                        break;
-
-                    default:
-                        break;
-                }
-            }
+    // check if the topic has at least one subscription
+    auto subscriptionIt = subscriptions.find(messageInfo.topicId);
+    if (subscriptionIt == subscriptions.end()) {
+        return;
+    }
+
+    const std::vector<SubscriptionInfo>& topicSubscriptions = subscriptionIt->second;
+
+    // one datagram for all the ready subscribers once the fan-out reaches the threshold
+    bool isMulticastSent = false;
+
+    if (isMulticastPublish(messageInfo)) {
+        int fanOut = countMulticastReadySubscribers(topicSubscriptions, messageInfo.topicId);
+
+        if (fanOut > 0 && fanOut >= multicastFanOutThreshold) {
+            sendMulticastPublish(messageInfo, fanOut);
+            isMulticastSent = true;
+        }
+    }
+
+    for (const auto& subscription : topicSubscriptions) {
+        // retrieve the subscriber slot, address and port
+        ClientSlot* clientSlot = getSubscriberClientSlot(subscription.subscriberHandle);
+
+        // skip the subscribers already reached by the multicast datagram
+        if (isMulticastSent && isMulticastReadySubscriber(clientSlot, messageInfo.topicId)) {
+            continue;
         }
+
+        dispatchPublishToSubscriber(clientSlot, subscription.qos, messageInfo, isMessageAdded);
+    }
+}
+
+void MqttSNServer::dispatchPublishToSubscriber(ClientSlot* clientSlot, QoS subscriptionQoS, const MessageInfo& messageInfo,
+                                               bool& isMessageAdded)
+{
+    const inet::L3Address& subscriberAddress = clientSlot->clientAddress;
+    const int& subscriberPort = clientSlot->clientPort;
+
+    // calculate the minimum QoS level between subscription QoS and incoming publish QoS
+    QoS resultQoS = NumericHelper::minQoS(subscriptionQoS, messageInfo.qos);
+
+    // check subscriber state and handle accordingly
+    switch (clientSlot->clientInfo.currentState) {
+        case ClientState::ACTIVE:
+            // check if the subscriber is registered for the topic and take appropriate action
+            processRequestForActiveSubscriber(subscriberAddress, subscriberPort, messageInfo, resultQoS, isMessageAdded);
+            break;
+
+        case ClientState::AWAKE:
+            // registered topic; send request directly, keeping only QoS 1 and 2 requests
+            processRequest(subscriberAddress, subscriberPort, messageInfo, resultQoS, isMessageAdded);
+            break;
+
+        case ClientState::ASLEEP:
+            // keep the request to be processed later
+            bufferRequest(subscriberAddress, subscriberPort, messageInfo, isMessageAdded);
+            break;
+
+        default:
+            break;
     }
 }
 
@@ -1728,7 +2043,7 @@ void MqttSNServer::addAndSendPublishRequest(const inet::L3Address& subscriberAdd
     if (resultQoS == QoS::QOS_MINUS_ONE || resultQoS == QoS::QOS_ZERO) {
         // send a publish message with QoS -1 or QoS 0 to the subscriber
         sendPublish(subscriberAddress, subscriberPort, messageInfo.dup, resultQoS, messageInfo.retain,
-                    messageInfo.topicIdType, messageInfo.topicId, 0, messageInfo.data, messageInfo.tagInfo);
+                    messageInfo.topicIdType, messageInfo.topicId, 0, messageInfo.data, messageInfo.tagInfo, messageInfo.compressed);
 
         // continue to the next subscriber
         return;
@@ -1738,7 +2053,13 @@ void MqttSNServer::addAndSendPublishRequest(const inet::L3Address& subscriberAdd
 
     // send a publish message with QoS 1 or QoS 2 to the subscriber
     sendPublish(subscriberAddress, subscriberPort, messageInfo.dup, resultQoS, messageInfo.retain,
-                messageInfo.topicIdType, messageInfo.topicId, currentRequestId, messageInfo.data, messageInfo.tagInfo);
+                messageInfo.topicIdType, messageInfo.topicId, currentRequestId, messageInfo.data, messageInfo.tagInfo,
+                messageInfo.compressed);
+
+    RequestInfo& requestInfo = requests[currentRequestId];
+    requestInfo.deadline = requestInfo.requestTime + MqttSNApp::getRetransmissionTimeout(subscriberAddress, subscriberPort, 0);
+
+    addRetransmissionDeadline(requestInfo.deadline, false, currentRequestId);
 }
 
 void MqttSNServer::addNewRequest(const inet::L3Address& subscriberAddress, const int& subscriberPort, MsgType messageType, bool sendAtLeastOnce,
@@ -1755,33 +2076,46 @@ void MqttSNServer::addNewRequest(const inet::L3Address& subscriberAddress, const
 
     RequestInfo requestInfo;
     requestInfo.requestTime = getClockTime();
-    requestInfo.subscriberAddress = subscriberAddress;
-    requestInfo.subscriberPort = subscriberPort;
+    requestInfo.subscriberHandle = getClientHandle(subscriberAddress, subscriberPort);
     requestInfo.messageType = messageType;
     requestInfo.sendAtLeastOnce = sendAtLeastOnce;
 
     if (messagesKey > 0) {
         requestInfo.messagesKey = messagesKey;
+        addMessageReference(messagesKey);
     }
 
     if (retainMessagesKey > 0) {
         requestInfo.retainMessagesKey = retainMessagesKey;
     }
 
-    // add the new request in the data structures
+    // add the new request in the data structures and in the subscriber queue
     requests[currentRequestId] = requestInfo;
-    requestIds.insert(currentRequestId);
+
+    getSubscriberClientSlot(requestInfo.subscriberHandle)->subscriberInfo.requestIds.insert(currentRequestId);
+
+    // requests sent right away only come back through their retransmission deadline
+    if (sendAtLeastOnce) {
+        markSubscriberReady(requestInfo.subscriberHandle);
+    }
 }
 
-void MqttSNServer::deleteRequest(std::map<uint16_t, RequestInfo>::iterator& requestIt, std::set<uint16_t>::iterator& requestIdIt)
+void MqttSNServer::deleteRequest(std::map<uint16_t, RequestInfo>::iterator& requestIt)
 {
-    // remove the request from both structures
+    // remove the request from the subscriber queue
+    getSubscriberClientSlot(requestIt->second.subscriberHandle)->subscriberInfo.requestIds.erase(requestIt->first);
+
+    // release the stored message referenced by the request
+    if (requestIt->second.messagesKey > 0) {
+        releaseMessageReference(requestIt->second.messagesKey);
+    }
+
+    // release the request ID and remove the request
+    requestIds.release(requestIt->first);
     requestIt = requests.erase(requestIt);
-    requestIdIt = requestIds.erase(requestIdIt);
 }
 
-bool MqttSNServer::isValidRequest(uint16_t requestId, MsgType messageType, std::map<uint16_t, RequestInfo>::iterator& requestIt,
-                                  std::set<uint16_t>::iterator& requestIdIt)
+bool MqttSNServer::isValidRequest(uint16_t requestId, MsgType messageType, std::map<uint16_t, RequestInfo>::iterator& requestIt)
 {
     // search for the request ID in the map
     requestIt = requests.find(requestId);
@@ -1790,48 +2124,37 @@ bool MqttSNServer::isValidRequest(uint16_t requestId, MsgType messageType, std::
     }
 
     // check if the request message type matches
-    if (requestIt->second.messageType != messageType) {
-        return false;
-    }
-
-    // search for the request ID in the set
-    requestIdIt = requestIds.find(requestId);
-    if (requestIdIt == requestIds.end()) {
-        return false;
-    }
-
-    return true;
+    return requestIt->second.messageType == messageType;
 }
 
 bool MqttSNServer::processRequestAck(uint16_t requestId, MsgType messageType)
 {
     std::map<uint16_t, RequestInfo>::iterator requestIt;
-    std::set<uint16_t>::iterator requestIdIt;
 
-    // check if the request is valid and retrieve iterators
-    if (!isValidRequest(requestId, messageType, requestIt, requestIdIt)) {
+    // check if the request is valid and retrieve the iterator
+    if (!isValidRequest(requestId, messageType, requestIt)) {
         return false;
     }
 
-    deleteRequest(requestIt, requestIdIt);
+    RequestInfo& requestInfo = requestIt->second;
+    sampleRoundTripTime(requestInfo.subscriberHandle, requestInfo.requestTime, requestInfo.retransmissionCounter);
+
+    deleteRequest(requestIt);
     return true;
 }
 
 void MqttSNServer::manageRegistration(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId)
 {
-    std::string topicName = StringHelper::base64Decode(getTopicById(topicId).topicName);
-
-    // check for topics structure alignment by verifying the encoded topic name and its corresponding topic ID
-    checkTopicsToIds(StringHelper::base64Encode(topicName), topicId);
+    // the interned topic name is shared with the registration; no copy is stored
+    const std::string& topicName = topicRegistry.getTopicName(topicId);
 
     // add a new registration entry
-    addNewRegistration(subscriberAddress, subscriberPort, topicName, topicId);
+    addNewRegistration(subscriberAddress, subscriberPort, topicId);
 
     sendRegister(subscriberAddress, subscriberPort, topicId, currentRegistrationId, topicName);
 }
 
-void MqttSNServer::addNewRegistration(const inet::L3Address& subscriberAddress, const int& subscriberPort, const std::string& topicName,
-                                      uint16_t topicId)
+void MqttSNServer::addNewRegistration(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId)
 {
     // set new available registration ID if possible; otherwise, throw an exception
     MqttSNApp::getNewIdentifier(registrationIds, currentRegistrationId,
@@ -1839,44 +2162,207 @@ void MqttSNServer::addNewRegistration(const inet::L3Address& subscriberAddress,
 
     RegisterInfo registerInfo;
     registerInfo.requestTime = getClockTime();
-    registerInfo.subscriberAddress = subscriberAddress;
-    registerInfo.subscriberPort = subscriberPort;
-    registerInfo.topicName = topicName;
+    registerInfo.deadline = registerInfo.requestTime + MqttSNApp::getRetransmissionTimeout(subscriberAddress, subscriberPort, 0);
+    registerInfo.subscriberHandle = getClientHandle(subscriberAddress, subscriberPort);
     registerInfo.topicId = topicId;
 
     // add the new registration in the data structures
     registrations[currentRegistrationId] = registerInfo;
-    registrationIds.insert(currentRegistrationId);
+
+    addRetransmissionDeadline(registerInfo.deadline, true, currentRegistrationId);
 }
 
-void MqttSNServer::deleteRegistration(std::map<uint16_t, RegisterInfo>::iterator& registrationIt, std::set<uint16_t>::iterator& registrationIdIt)
+void MqttSNServer::deleteRegistration(std::map<uint16_t, RegisterInfo>::iterator& registrationIt)
 {
-    // remove the registration from both structures
+    // release the registration ID and remove the registration
+    registrationIds.release(registrationIt->first);
     registrationIt = registrations.erase(registrationIt);
-    registrationIdIt = registrationIds.erase(registrationIdIt);
 }
 
 bool MqttSNServer::processRegistrationAck(uint16_t registrationId)
 {
-    std::map<uint16_t, RegisterInfo>::iterator registrationIt;
-    std::set<uint16_t>::iterator registrationIdIt;
-
     // search for the registration ID in the map
-    registrationIt = registrations.find(registrationId);
+    auto registrationIt = registrations.find(registrationId);
     if (registrationIt == registrations.end()) {
         return false;
     }
 
-    // search for the registration ID in the set
-    registrationIdIt = registrationIds.find(registrationId);
-    if (registrationIdIt == registrationIds.end()) {
-        return false;
-    }
+    RegisterInfo& registerInfo = registrationIt->second;
+    sampleRoundTripTime(registerInfo.subscriberHandle, registerInfo.requestTime, registerInfo.retransmissionCounter);
 
-    deleteRegistration(registrationIt, registrationIdIt);
+    deleteRegistration(registrationIt);
     return true;
 }
 
+void MqttSNServer::handleRegistrationDeadline(const RetransmissionDeadline& retransmissionDeadline)
+{
+    uint16_t registrationId = retransmissionDeadline.id;
+
+    auto registrationIt = registrations.find(registrationId);
+    if (registrationIt == registrations.end()) {
+        // the registration was acknowledged in the meantime
+        return;
+    }
+
+    RegisterInfo& registerInfo = registrationIt->second;
+
+    // skip outdated deadlines of registrations that were sent again
+    if (registerInfo.deadline != retransmissionDeadline.deadline) {
+        return;
+    }
+
+    // check if the number of retries equals the threshold
+    if (registerInfo.retransmissionCounter >= MqttSNApp::retransmissionCounter) {
+        uint32_t subscriberHandle = registerInfo.subscriberHandle;
+        deleteRegistration(registrationIt);
+
+        // let the subscriber queue retry the registration for its buffered requests
+        markSubscriberReady(subscriberHandle);
+        return;
+    }
+
+    ClientSlot* clientSlot = getSubscriberClientSlot(registerInfo.subscriberHandle);
+    sendRegister(clientSlot->clientAddress, clientSlot->clientPort, registerInfo.topicId, registrationId,
+                 topicRegistry.getTopicName(registerInfo.topicId));
+
+    // update the registration
+    registerInfo.retransmissionCounter++;
+    registerInfo.requestTime = getClockTime();
+    registerInfo.deadline = registerInfo.requestTime + MqttSNApp::getRetransmissionTimeout(clientSlot->clientAddress, clientSlot->clientPort,
+                                                                                            registerInfo.retransmissionCounter);
+
+    addRetransmissionDeadline(registerInfo.deadline, true, registrationId);
+
+    MqttSNApp::serversRetransmissions++;
+}
+
+void MqttSNServer::refreshClientActivity(uint32_t clientHandle, ClientInfo* clientInfo)
+{
+    clientInfo->lastReceivedMsgTime = getClockTime();
+
+    // move the supervision deadline forward; the queued entry is revisited lazily
+    updateClientSupervision(clientHandle, clientInfo);
+}
+
+void MqttSNServer::updateClientSupervision(uint32_t clientHandle, ClientInfo* clientInfo)
+{
+    // derive the supervision deadline from the client state
+    if (clientInfo->currentState == ClientState::ACTIVE) {
+        clientInfo->supervisionDeadline = clientInfo->lastReceivedMsgTime + clientInfo->keepAliveDuration;
+    }
+    else if (clientInfo->currentState == ClientState::ASLEEP) {
+        clientInfo->supervisionDeadline = clientInfo->lastReceivedMsgTime + clientInfo->sleepDuration;
+    }
+    else {
+        clientInfo->supervisionDeadline = 0;
+        return;
+    }
+
+    queueClientSupervision(clientHandle, clientInfo);
+}
+
+void MqttSNServer::queueClientSupervision(uint32_t clientHandle, ClientInfo* clientInfo)
+{
+    // a queued entry that expires no later than the deadline is enough; it is re-queued when visited
+    if (clientInfo->queuedSupervisionDeadline > 0 && clientInfo->queuedSupervisionDeadline <= clientInfo->supervisionDeadline) {
+        return;
+    }
+
+    SupervisionDeadline supervisionDeadline;
+    supervisionDeadline.deadline = clientInfo->supervisionDeadline;
+    supervisionDeadline.clientHandle = clientHandle;
+
+    supervisionDeadlines.push(supervisionDeadline);
+    clientInfo->queuedSupervisionDeadline = supervisionDeadline.deadline;
+
+    armClientsSupervisionEvent();
+}
+
+void MqttSNServer::expireClientSupervision(ClientSlot* clientSlot, uint32_t clientHandle)
+{
+    ClientInfo* clientInfo = &clientSlot->clientInfo;
+
+    if (clientInfo->currentState == ClientState::ACTIVE && !clientInfo->sentPingReq) {
+        // send a solicitation ping request to the expired client and wait for its response
+        MqttSNApp::sendPingReq(clientSlot->clientAddress, clientSlot->clientPort);
+        clientInfo->sentPingReq = true;
+
+        clientInfo->supervisionDeadline = getClockTime() + pingRespWaitInterval;
+        queueClientSupervision(clientHandle, clientInfo);
+        return;
+    }
+
+    // change the expired client state and activate the will feature
+    updateClientState(clientHandle, clientInfo, ClientState::LOST);
+    clientInfo->supervisionDeadline = 0;
+    // will feature activation; to be implemented
+}
+
+void MqttSNServer::armClientsSupervisionEvent()
+{
+    // nothing to arm without supervised clients
+    if (supervisionDeadlines.empty()) {
+        return;
+    }
+
+    inet::clocktime_t earliestDeadline = std::max(supervisionDeadlines.top().deadline, getClockTime());
+
+    if (clientsSupervisionEvent->isScheduled()) {
+        // keep the event if it already fires no later than the earliest deadline
+        if (clientsSupervisionEvent->getArrivalClockTime() <= earliestDeadline) {
+            return;
+        }
+
+        cancelEvent(clientsSupervisionEvent);
+    }
+
+    scheduleClockEventAt(earliestDeadline, clientsSupervisionEvent);
+}
+
+void MqttSNServer::addRetransmissionDeadline(inet::clocktime_t deadline, bool isRegistration, uint16_t id)
+{
+    RetransmissionDeadline retransmissionDeadline;
+    retransmissionDeadline.deadline = deadline;
+    retransmissionDeadline.isRegistration = isRegistration;
+    retransmissionDeadline.id = id;
+
+    retransmissionDeadlines.push(retransmissionDeadline);
+
+    armRetransmissionEvent();
+}
+
+void MqttSNServer::sampleRoundTripTime(uint32_t subscriberHandle, inet::clocktime_t requestTime, int retransmissionCounter)
+{
+    // Karn's rule: the ACK of a retransmitted message cannot be matched to a single send
+    if (retransmissionCounter > 0) {
+        return;
+    }
+
+    ClientSlot* clientSlot = getSubscriberClientSlot(subscriberHandle);
+    MqttSNApp::addRttSample(clientSlot->clientAddress, clientSlot->clientPort, (getClockTime() - requestTime).dbl());
+}
+
+void MqttSNServer::armRetransmissionEvent()
+{
+    // nothing to arm without pending deadlines
+    if (retransmissionDeadlines.empty()) {
+        return;
+    }
+
+    inet::clocktime_t earliestDeadline = std::max(retransmissionDeadlines.top().deadline, getClockTime());
+
+    if (retransmissionEvent->isScheduled()) {
+        // keep the event if it already fires no later than the earliest deadline
+        if (retransmissionEvent->getArrivalClockTime() <= earliestDeadline) {
+            return;
+        }
+
+        cancelEvent(retransmissionEvent);
+    }
+
+    scheduleClockEventAt(earliestDeadline, retransmissionEvent);
+}
+
 void MqttSNServer::setAllSubscriberTopics(const inet::L3Address& subscriberAddress, const int& subscriberPort, bool isRegistered,
                                           bool skipPredefinedTopics)
 {
@@ -1896,6 +2382,8 @@ void MqttSNServer::setAllSubscriberTopics(const inet::L3Address& subscriberAddre
         // update the registration status
         topic.second.isRegistered = isRegistered;
     }
+
+    updateMinusOneRoutes(getClientHandle(subscriberAddress, subscriberPort));
 }
 
 void MqttSNServer::handleSubscriberPingRequest(const inet::L3Address& subscriberAddress, const int& subscriberPort)
@@ -1912,6 +2400,30 @@ void MqttSNServer::handleSubscriberPingRequest(const inet::L3Address& subscriber
     }
 }
 
+void MqttSNServer::markSubscriberReady(uint32_t subscriberHandle)
+{
+    ClientSlot* clientSlot = getClientSlot(subscriberHandle);
+
+    // only subscribers with queued requests have work to send
+    if (clientSlot == nullptr || !clientSlot->isSubscriber || clientSlot->subscriberInfo.requestIds.empty()) {
+        return;
+    }
+
+    ClientState subscriberState = clientSlot->clientInfo.currentState;
+
+    // only ACTIVE or AWAKE subscribers can receive the queued requests
+    if (subscriberState != ClientState::ACTIVE && subscriberState != ClientState::AWAKE) {
+        return;
+    }
+
+    readySubscribers.insert(subscriberHandle);
+
+    // arm the requests check event only when there is work to send
+    if (!requestsCheckEvent->isScheduled()) {
+        scheduleClockEventAfter(requestsCheckInterval, requestsCheckEvent);
+    }
+}
+
 void MqttSNServer::manageAwakenSubscriberEvent(const inet::L3Address& srcAddress, const int& srcPort,
                                                SubscriberInfo* subscriberInfo)
 {
@@ -1919,8 +2431,7 @@ void MqttSNServer::manageAwakenSubscriberEvent(const inet::L3Address& srcAddress
 
     // add parameters
     subscriberInfo->awakenSubscriberCheckEvent->addPar("isAwakenSubscriberCheckEvent");
-    subscriberInfo->awakenSubscriberCheckEvent->addPar("subscriberAddress").setStringValue(srcAddress.str().c_str());
-    subscriberInfo->awakenSubscriberCheckEvent->addPar("subscriberPort").setLongValue(srcPort);
+    subscriberInfo->awakenSubscriberCheckEvent->addPar("subscriberHandle").setLongValue(getClientHandle(srcAddress, srcPort));
 
     // record the start time of the schedule
     subscriberInfo->awakenSubscriberCheckStartTime = getClockTime();
@@ -1929,6 +2440,21 @@ void MqttSNServer::manageAwakenSubscriberEvent(const inet::L3Address& srcAddress
     scheduleClockEventAfter(awakenSubscriberCheckInterval, subscriberInfo->awakenSubscriberCheckEvent);
 }
 
+inet::clocktime_t MqttSNServer::getLatestRequestDeadline(const SubscriberInfo* subscriberInfo)
+{
+    inet::clocktime_t latestDeadline = 0;
+
+    // every retransmission moves the deadline forward, so this covers the whole backoff of the pending requests
+    for (uint16_t requestId : subscriberInfo->requestIds) {
+        auto requestIt = requests.find(requestId);
+        if (requestIt != requests.end()) {
+            latestDeadline = std::max(latestDeadline, requestIt->second.deadline);
+        }
+    }
+
+    return latestDeadline;
+}
+
 bool MqttSNServer::isTopicRegisteredForSubscriber(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId)
 {
     SubscriberTopicInfo* subscriberTopicInfo = getSubscriberTopicInfo(subscriberAddress, subscriberPort, topicId);
@@ -1944,22 +2470,27 @@ bool MqttSNServer::isTopicRegisteredForSubscriber(const inet::L3Address& subscri
 SubscriberInfo* MqttSNServer::getSubscriberInfo(const inet::L3Address& subscriberAddress, const int& subscriberPort,
                                                 bool insertIfNotFound)
 {
-    // create a pair for subscriber address and port
-    std::pair<inet::L3Address, int> subscriberKey = std::make_pair(subscriberAddress, subscriberPort);
+    // check if the client with the specified address and port is present in the data structure
+    ClientSlot* clientSlot = getClientSlot(getClientHandle(subscriberAddress, subscriberPort));
+
+    if (clientSlot == nullptr) {
+        if (insertIfNotFound) {
+            throw omnetpp::cRuntimeError("Client not found while adding subscriber information");
+        }
 
-    // check if the subscriber with the specified address and port is present in the data structure
-    auto subscriberIterator = subscribers.find(subscriberKey);
+        return nullptr;
+    }
 
-    if (subscriberIterator != subscribers.end()) {
-        return &subscriberIterator->second;
+    if (clientSlot->isSubscriber) {
+        return &clientSlot->subscriberInfo;
     }
 
     if (insertIfNotFound) {
-        // insert a new default subscriber
-        SubscriberInfo subscriberInfo;
-        subscribers[subscriberKey] = subscriberInfo;
+        // mark the slot as subscriber with default subscriber information
+        clientSlot->isSubscriber = true;
+        clientSlot->subscriberInfo = SubscriberInfo();
 
-        return &subscribers[subscriberKey];
+        return &clientSlot->subscriberInfo;
     }
 
     return nullptr;
@@ -1996,186 +2527,291 @@ ClientInfo* MqttSNServer::getSubscriberClientInfo(const inet::L3Address& subscri
     return clientInfo;
 }
 
-void MqttSNServer::deleteSubscriptionIfExists(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId)
+ClientSlot* MqttSNServer::getSubscriberClientSlot(uint32_t subscriberHandle)
 {
-    // check for an existing subscription and delete it if found
-    std::pair<uint16_t, QoS> subscriptionKey;
-    if (findSubscription(subscriberAddress, subscriberPort, topicId, subscriptionKey)) {
-        deleteSubscription(subscriberAddress, subscriberPort, subscriptionKey);
+    // get the client slot for the subscriber
+    ClientSlot* clientSlot = getClientSlot(subscriberHandle);
+    if (clientSlot == nullptr) {
+        throw omnetpp::cRuntimeError("Unable to find client slot for subscriber (Handle: %u).", subscriberHandle);
     }
+
+    return clientSlot;
+}
+
+void MqttSNServer::deleteSubscriptionIfExists(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId)
+{
+    // delete the subscription if found; the subscriber topics act as the reverse index
+    deleteSubscription(subscriberAddress, subscriberPort, topicId);
 }
 
 bool MqttSNServer::findSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId,
-                                    std::pair<uint16_t, QoS>& subscriptionKey)
-{
-    // keys with the same topic ID
-    std::set<std::pair<uint16_t, QoS>> keys = getSubscriptionKeysByTopicId(topicId);
-
-    // iterate for each QoS
-    for (const auto& key : keys) {
-        // check if the subscription exists for the given key
-        auto subscriptionIt = subscriptions.find(key);
-        if (subscriptionIt != subscriptions.end()) {
-            // check if the subscriber is present in the subscription set
-            const auto& subscribers = subscriptionIt->second;
-
-            auto subscriberIt = subscribers.find(std::make_pair(subscriberAddress, subscriberPort));
-            if (subscriberIt != subscribers.end()) {
-                // subscriber found, update the subscription key parameter and return true
-                subscriptionKey = key;
-                return true;
-            }
-        }
+                                    QoS& subscriptionQoS)
+{
+    SubscriberInfo* subscriberInfo = getSubscriberInfo(subscriberAddress, subscriberPort);
+    if (subscriberInfo == nullptr) {
+        return false;
     }
 
-    // return false if the subscriber has no subscription
-    return false;
+    // check if the subscriber has a subscription for the topic
+    auto topicIt = subscriberInfo->subscriberTopics.find(topicId);
+    if (topicIt == subscriberInfo->subscriberTopics.end()) {
+        return false;
+    }
+
+    // subscriber found, update the subscription QoS parameter and return true
+    subscriptionQoS = topicIt->second.qos;
+    return true;
 }
 
 bool MqttSNServer::insertSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId,
                                       TopicIdType topicIdType, QoS qos)
 {
-    // create key pairs
-    std::pair<uint16_t, QoS> subscriptionKey = std::make_pair(topicId, qos);
-    std::pair<inet::L3Address, int> subscriberKey = std::make_pair(subscriberAddress, subscriberPort);
-
-    // check if the subscription key already exists in the map
-    auto subscriptionIt = subscriptions.find(subscriptionKey);
-    if (subscriptionIt != subscriptions.end()) {
-        // if the key exists, access the subscribers
-        auto& subscribers = subscriptionIt->second;
-
-        // check if the subscriber already exists for the given address and port
-        if (subscribers.find(subscriberKey) != subscribers.end()) {
-            // if the subscriber already exists, return false
-            return false;
-        }
+    // retrieve the subscriber
+    SubscriberInfo* subscriberInfo = getSubscriberInfo(subscriberAddress, subscriberPort, true);
 
-        // insert the new subscriber into the existing subscription
-        subscribers.insert(subscriberKey);
+    // check if the subscriber already has a subscription for the topic
+    if (subscriberInfo->subscriberTopics.find(topicId) != subscriberInfo->subscriberTopics.end()) {
+        return false;
     }
-    else {
-        // create a new subscription and insert the new subscriber
-        subscriptions[subscriptionKey].insert(subscriberKey);
 
-        // insert the QoS value associated with the topic ID
-        topicIdToQoS[topicId].insert(qos);
-    }
+    // append the subscriber to the topic subscription list
+    std::vector<SubscriptionInfo>& topicSubscriptions = subscriptions[topicId];
 
-    // retrieve the subscriber
-    SubscriberInfo* subscriberInfo = getSubscriberInfo(subscriberAddress, subscriberPort, true);
+    SubscriptionInfo subscriptionInfo;
+    subscriptionInfo.subscriberHandle = getClientHandle(subscriberAddress, subscriberPort);
+    subscriptionInfo.qos = qos;
+
+    topicSubscriptions.push_back(subscriptionInfo);
 
-    // add a new subscription topic
+    // add a new subscription topic pointing back to the list entry
     SubscriberTopicInfo subscriberTopicInfo;
     subscriberTopicInfo.topicIdType = topicIdType;
     subscriberTopicInfo.isRegistered = true;
+    subscriberTopicInfo.qos = qos;
+    subscriberTopicInfo.subscriptionIndex = topicSubscriptions.size() - 1;
 
     subscriberInfo->subscriberTopics[topicId] = subscriberTopicInfo;
+    updateMinusOneRoute(topicId, subscriptionInfo.subscriberHandle);
 
     // return true if the insertion is successful
     return true;
 }
 
-bool MqttSNServer::deleteSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort,
-                                      const std::pair<uint16_t, QoS>& subscriptionKey)
-{
-    // search for the subscription key in the map
-    auto subscriptionIt = subscriptions.find(subscriptionKey);
-    if (subscriptionIt != subscriptions.end()) {
-        // if the key is found, access the subscribers
-        auto& subscribers = subscriptionIt->second;
-
-        // check if the subscriber is present
-        auto subscriberIt = subscribers.find(std::make_pair(subscriberAddress, subscriberPort));
-        if (subscriberIt != subscribers.end()) {
-            // delete the subscriber from the map
-            subscribers.erase(subscriberIt);
-
-            // check if there are no more subscribers for this subscription key
-            if (subscribers.empty()) {
-                // remove the subscription key from subscriptions
-                subscriptions.erase(subscriptionIt);
-
-                // remove the QoS associated with topic ID if there are no more subscribers
-                auto qosSetIt = topicIdToQoS.find(subscriptionKey.first);
-                if (qosSetIt != topicIdToQoS.end()) {
-                    auto& qosSet = qosSetIt->second;
-                    qosSet.erase(subscriptionKey.second);
-
-                    // remove the topic ID if no more QoS are associated
-                    if (qosSet.empty()) {
-                        topicIdToQoS.erase(qosSetIt);
-                    }
-                }
-            }
+bool MqttSNServer::deleteSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId)
+{
+    SubscriberInfo* subscriberInfo = getSubscriberInfo(subscriberAddress, subscriberPort);
+    if (subscriberInfo == nullptr) {
+        return false;
+    }
 
-            // retrieve the subscriber and delete the subscription topic
-            SubscriberInfo* subscriberInfo = getSubscriberInfo(subscriberAddress, subscriberPort, true);
-            subscriberInfo->subscriberTopics.erase(subscriptionKey.first);
+    // check if the subscriber has a subscription for the topic
+    auto topicIt = subscriberInfo->subscriberTopics.find(topicId);
+    if (topicIt == subscriberInfo->subscriberTopics.end()) {
+        return false;
+    }
 
-            // delete operation is successful
-            return true;
-        }
+    auto subscriptionIt = subscriptions.find(topicId);
+    if (subscriptionIt == subscriptions.end()) {
+        throw omnetpp::cRuntimeError("Mismatch between subscription structures during subscription removal");
     }
 
-    // delete operation is failed
-    return false;
+    std::vector<SubscriptionInfo>& topicSubscriptions = subscriptionIt->second;
+    size_t index = topicIt->second.subscriptionIndex;
+
+    // move the last entry into the freed position and update its reverse index
+    if (index != topicSubscriptions.size() - 1) {
+        topicSubscriptions[index] = topicSubscriptions.back();
+
+        ClientSlot* movedSlot = getSubscriberClientSlot(topicSubscriptions[index].subscriberHandle);
+        getSubscriberTopicInfo(movedSlot->clientAddress, movedSlot->clientPort, topicId)->subscriptionIndex = index;
+    }
+
+    topicSubscriptions.pop_back();
+
+    // remove the topic ID if there are no more subscribers
+    if (topicSubscriptions.empty()) {
+        subscriptions.erase(subscriptionIt);
+    }
+
+    // delete the subscription topic
+    removeFromMinusOneRoute(topicId, &topicIt->second);
+    subscriberInfo->subscriberTopics.erase(topicIt);
+
+    // delete operation is successful
+    return true;
 }
 
-std::set<std::pair<uint16_t, QoS>> MqttSNServer::getSubscriptionKeysByTopicId(uint16_t topicId)
+void MqttSNServer::updateMinusOneRoute(uint16_t topicId, uint32_t subscriberHandle)
 {
-    std::set<std::pair<uint16_t, QoS>> keys = {};
+    // only predefined topics carry QoS -1 publications; multicast ones use the general dispatch
+    auto topicIt = idsToTopics.find(topicId);
+    if (topicIt == idsToTopics.end() || topicIt->second.topicIdType != TopicIdType::PRE_DEFINED_TOPIC_ID || topicIt->second.multicast) {
+        return;
+    }
+
+    ClientSlot* clientSlot = getClientSlot(subscriberHandle);
+    if (clientSlot == nullptr || !clientSlot->isSubscriber) {
+        return;
+    }
 
-    // check if the topic ID key exists in the map
-    auto topicIt = topicIdToQoS.find(topicId);
-    if (topicIt == topicIdToQoS.end()) {
-        // if the topic ID doesn't exist, return an empty set
-        return keys;
+    auto subscriberTopicIt = clientSlot->subscriberInfo.subscriberTopics.find(topicId);
+    if (subscriberTopicIt == clientSlot->subscriberInfo.subscriberTopics.end()) {
+        return;
     }
 
-    const auto& qosSet = topicIt->second;
-    // generate complete <topicId, QoS> keys and insert into the set
-    for (const auto& qos : qosSet) {
-        keys.insert(std::make_pair(topicId, qos));
+    SubscriberTopicInfo& subscriberTopicInfo = subscriberTopicIt->second;
+    removeFromMinusOneRoute(topicId, &subscriberTopicInfo);
+
+    ClientState clientState = clientSlot->clientInfo.currentState;
+
+    if (clientState == ClientState::AWAKE || (clientState == ClientState::ACTIVE && subscriberTopicInfo.isRegistered)) {
+        MinusOneRoute& route = minusOneRoutes[topicId];
+        route.readyHandles.push_back(subscriberHandle);
+        route.readyEndpoints.emplace_back(clientSlot->clientAddress, clientSlot->clientPort);
+
+        subscriberTopicInfo.inMinusOneRoute = true;
+        subscriberTopicInfo.minusOneRouteReady = true;
+        subscriberTopicInfo.minusOneRouteIndex = route.readyHandles.size() - 1;
     }
+    else if (clientState == ClientState::ACTIVE || clientState == ClientState::ASLEEP) {
+        // requests have to be buffered or preceded by a registration
+        MinusOneRoute& route = minusOneRoutes[topicId];
+        route.pendingHandles.push_back(subscriberHandle);
 
-    return keys;
+        subscriberTopicInfo.inMinusOneRoute = true;
+        subscriberTopicInfo.minusOneRouteReady = false;
+        subscriberTopicInfo.minusOneRouteIndex = route.pendingHandles.size() - 1;
+    }
 }
 
-bool MqttSNServer::checkClientsCongestion()
+void MqttSNServer::updateMinusOneRoutes(uint32_t subscriberHandle)
 {
-    // verify congestion based on the number of clients connected
-    return clients.size() >= (unsigned int) par("maximumClients");
+    ClientSlot* clientSlot = getClientSlot(subscriberHandle);
+    if (clientSlot == nullptr || !clientSlot->isSubscriber) {
+        return;
+    }
+
+    for (const auto& topic : clientSlot->subscriberInfo.subscriberTopics) {
+        updateMinusOneRoute(topic.first, subscriberHandle);
+    }
 }
 
-bool MqttSNServer::checkIDSpaceCongestion(const std::set<uint16_t>& usedIds, bool allowMaxValue)
+void MqttSNServer::removeFromMinusOneRoute(uint16_t topicId, SubscriberTopicInfo* subscriberTopicInfo)
 {
-    // check for invalid message ID; ID=0 is invalid
-    if (usedIds.find(0) != usedIds.end()) {
-        throw omnetpp::cRuntimeError("Invalid message ID=0 detected in the set");
+    if (!subscriberTopicInfo->inMinusOneRoute) {
+        return;
     }
 
-    // check for invalid message ID; ID=UINT16_MAX can be considered invalid
-    if (!allowMaxValue && usedIds.find(UINT16_MAX) != usedIds.end()) {
-        throw omnetpp::cRuntimeError("Invalid message ID=UINT16_MAX detected in the set");
+    auto routeIt = minusOneRoutes.find(topicId);
+    if (routeIt == minusOneRoutes.end()) {
+        throw omnetpp::cRuntimeError("Mismatch between QoS -1 route structures during route removal");
     }
 
-    uint16_t maxValue = allowMaxValue ? UINT16_MAX : UINT16_MAX - 1;
+    MinusOneRoute& route = routeIt->second;
+    std::vector<uint32_t>& handles = subscriberTopicInfo->minusOneRouteReady ? route.readyHandles : route.pendingHandles;
+    size_t index = subscriberTopicInfo->minusOneRouteIndex;
+
+    // order does not matter; move the last entry into the freed position and update its reverse index
+    if (index != handles.size() - 1) {
+        handles[index] = handles.back();
+
+        if (subscriberTopicInfo->minusOneRouteReady) {
+            route.readyEndpoints[index] = route.readyEndpoints.back();
+        }
+
+        ClientSlot* movedSlot = getSubscriberClientSlot(handles[index]);
+        getSubscriberTopicInfo(movedSlot->clientAddress, movedSlot->clientPort, topicId)->minusOneRouteIndex = index;
+    }
 
-    // check if the size equals the maximum valid range of IDs
-    return (usedIds.size() == maxValue);
+    handles.pop_back();
+
+    if (subscriberTopicInfo->minusOneRouteReady) {
+        route.readyEndpoints.pop_back();
+    }
+
+    subscriberTopicInfo->inMinusOneRoute = false;
+
+    if (route.readyHandles.empty() && route.pendingHandles.empty()) {
+        minusOneRoutes.erase(routeIt);
+    }
+}
+
+bool MqttSNServer::isMulticastPublish(const MessageInfo& messageInfo)
+{
+    // only QoS -1 and QoS 0 need no per-subscriber state
+    if (messageInfo.qos != QoS::QOS_MINUS_ONE && messageInfo.qos != QoS::QOS_ZERO) {
+        return false;
+    }
+
+    auto topicIt = idsToTopics.find(messageInfo.topicId);
+
+    return topicIt != idsToTopics.end() && topicIt->second.multicast;
+}
+
+bool MqttSNServer::isMulticastReadySubscriber(ClientSlot* clientSlot, uint16_t topicId)
+{
+    // same subscribers that would receive the publication directly
+    ClientState clientState = clientSlot->clientInfo.currentState;
+
+    if (clientState == ClientState::AWAKE) {
+        return true;
+    }
+
+    if (clientState != ClientState::ACTIVE) {
+        return false;
+    }
+
+    const std::map<uint16_t, SubscriberTopicInfo>& subscriberTopics = clientSlot->subscriberInfo.subscriberTopics;
+    auto topicIt = subscriberTopics.find(topicId);
+
+    return topicIt != subscriberTopics.end() && topicIt->second.isRegistered;
+}
+
+int MqttSNServer::countMulticastReadySubscribers(const std::vector<SubscriptionInfo>& topicSubscriptions, uint16_t topicId)
+{
+    int readySubscribers = 0;
+
+    for (const auto& subscription : topicSubscriptions) {
+        if (isMulticastReadySubscriber(getSubscriberClientSlot(subscription.subscriberHandle), topicId)) {
+            readySubscribers++;
+        }
+    }
+
+    return readySubscribers;
+}
+
+void MqttSNServer::sendMulticastPublish(const MessageInfo& messageInfo, int fanOut)
+{
+    // the publication QoS is the delivered QoS since it does not exceed any subscription QoS
+    inet::Packet* packet = PacketHelper::getPublishPacket(messageInfo.dup, messageInfo.qos, messageInfo.retain, messageInfo.topicIdType,
+                                                          messageInfo.topicId, 0, messageInfo.data, messageInfo.tagInfo,
+                                                          messageInfo.compressed);
+
+    multicastPublishMsgs++;
+    multicastSavedPublishMsgs += fanOut - 1;
+    multicastSavedBytes += (uint64_t) packet->getByteLength() * (fanOut - 1);
+
+    MqttSNApp::corruptPacket(packet, MqttSNApp::packetBER);
+
+    MqttSNApp::sendPacket(packet, MqttSNApp::getMulticastGroup(gatewayId, messageInfo.topicId), par("destPort"));
+}
+
+bool MqttSNServer::checkClientsCongestion()
+{
+    // verify congestion based on the number of clients connected
+    return clientSlots.size() >= (unsigned int) par("maximumClients");
 }
 
 bool MqttSNServer::checkPublishCongestion(QoS qos, bool retain)
 {
     // check congestion for retained messages
-    if (retain && checkIDSpaceCongestion(retainMessageIds, false)) {
+    if (retain && retainMessageIds.isExhausted()) {
         return true;
     }
 
     // check congestion for QoS levels 1 and 2
     if (qos == QoS::QOS_ONE || qos == QoS::QOS_TWO) {
-        return (checkIDSpaceCongestion(requestIds) || checkIDSpaceCongestion(messageIds));
+        return (requestIds.isExhausted() || messageIds.isExhausted());
     }
 
     // no congestion detected
@@ -2184,8 +2820,8 @@ bool MqttSNServer::checkPublishCongestion(QoS qos, bool retain)
 
 void MqttSNServer::clearPublishersData()
 {
-    for (auto& publisherPair : publishers) {
-        auto& messages = publisherPair.second.messages;
+    for (auto& clientSlot : clientSlots) {
+        auto& messages = clientSlot.publisherInfo.messages;
 
         for (auto it = messages.begin(); it != messages.end();) {
             it = messages.erase(it);
@@ -2195,8 +2831,8 @@ void MqttSNServer::clearPublishersData()
 
 void MqttSNServer::clearSubscribersData()
 {
-    for (auto& subscriberPair : subscribers) {
-        auto& topics = subscriberPair.second.subscriberTopics;
+    for (auto& clientSlot : clientSlots) {
+        auto& topics = clientSlot.subscriberInfo.subscriberTopics;
 
         for (auto it = topics.begin(); it != topics.end();) {
             it = topics.erase(it);
@@ -2208,12 +2844,11 @@ MqttSNServer::~MqttSNServer()
 {
     cancelAndDelete(stateChangeEvent);
     cancelAndDelete(advertiseEvent);
-    cancelAndDelete(activeClientsCheckEvent);
-    cancelAndDelete(asleepClientsCheckEvent);
+    cancelAndDelete(clientsSupervisionEvent);
     cancelAndDelete(pendingRetainCheckEvent);
     cancelAndDelete(requestsCheckEvent);
-    cancelAndDelete(registrationsCheckEvent);
-    cancelAndDelete(messagesClearEvent);
+    cancelAndDelete(retransmissionEvent);
+    cancelAndDelete(ackBitmapEvent);
 }
 
 } /* namespace mqttsn */
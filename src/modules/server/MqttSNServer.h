@@ -2,39 +2,51 @@
 #define MODULES_SERVER_MQTTSNSERVER_H_
 
 #include "../MqttSNApp.h"
+#include "helpers/IdAllocator.h"
+#include "helpers/AckBitmapAccumulator.h"
 #include "types/shared/MsgType.h"
 #include "types/shared/ReturnCode.h"
 #include "types/shared/QoS.h"
 #include "types/shared/TopicIdType.h"
 #include "types/shared/ClientState.h"
 #include "types/shared/TagInfo.h"
+#include "types/shared/PayloadBuffer.h"
 #include "types/server/GatewayState.h"
 #include "types/server/ClientType.h"
 #include "types/server/ClientInfo.h"
 #include "types/server/DataInfo.h"
 #include "types/server/PublisherInfo.h"
 #include "types/server/TopicInfo.h"
-#include "types/server/RetainMessageInfo.h"
 #include "types/server/MessageInfo.h"
 #include "types/server/RequestInfo.h"
 #include "types/server/RegisterInfo.h"
 #include "types/server/SubscriberTopicInfo.h"
 #include "types/server/SubscriberInfo.h"
+#include "types/server/SubscriptionInfo.h"
+#include "types/server/ClientSlot.h"
+#include "types/server/ClientKeyHash.h"
+#include "types/server/RetransmissionDeadline.h"
+#include "types/server/SupervisionDeadline.h"
+#include "types/server/MinusOneRoute.h"
+#include <unordered_map>
+#include <queue>
 
 namespace mqttsn {
 
 class MqttSNServer : public MqttSNApp
 {
     protected:
+        // constants
+        static constexpr uint32_t INVALID_CLIENT_HANDLE = 0;
+
         // parameters
         uint16_t advertiseInterval;
-        double activeClientsCheckInterval;
-        double asleepClientsCheckInterval;
+        double pingRespWaitInterval;
         double pendingRetainCheckInterval;
         double requestsCheckInterval;
-        double registrationsCheckInterval;
         double awakenSubscriberCheckInterval;
-        double messagesClearInterval;
+        int multicastFanOutThreshold;
+        std::set<std::string> multicastTopics;
 
         // gateway state management
         inet::ClockEvent* stateChangeEvent = nullptr;
@@ -46,43 +58,58 @@ class MqttSNServer : public MqttSNApp
         static int gatewayIdCounter;
         uint8_t gatewayId = 0;
 
-        std::map<std::pair<inet::L3Address, int>, ClientInfo> clients;
-        inet::ClockEvent* activeClientsCheckEvent = nullptr;
-        inet::ClockEvent* asleepClientsCheckEvent = nullptr;
+        // slots are never freed and reserved up front, so slot pointers stay valid across addNewClient
+        std::vector<ClientSlot> clientSlots;
+        unsigned connectedClients = 0; // clients in ACTIVE, ASLEEP or AWAKE state, kept for the load hint
+        std::unordered_map<std::pair<inet::L3Address, int>, uint32_t, ClientKeyHash> clientHandles;
 
-        std::map<std::pair<inet::L3Address, int>, PublisherInfo> publishers;
+        inet::ClockEvent* clientsSupervisionEvent = nullptr;
+        std::priority_queue<SupervisionDeadline, std::vector<SupervisionDeadline>, std::greater<SupervisionDeadline>>
+                supervisionDeadlines;
 
-        std::map<std::string, uint16_t> topicsToIds;
+        TopicRegistry topicRegistry;
         std::map<uint16_t, TopicInfo> idsToTopics;
-        std::set<uint16_t> topicIds;
+        IdAllocator topicIds{false};
         uint16_t currentTopicId = 0;
 
-        std::map<uint16_t, RetainMessageInfo> retainMessages;
-        std::set<uint16_t> retainMessageIds;
+        std::map<uint16_t, MessageInfo> retainMessages;
+        IdAllocator retainMessageIds{false};
 
         inet::ClockEvent* pendingRetainCheckEvent = nullptr;
-        std::map<std::pair<inet::L3Address, int>, MessageInfo> pendingRetainMessages;
+        std::map<uint32_t, MessageInfo> pendingRetainMessages;
 
         std::map<uint16_t, MessageInfo> messages;
-        std::set<uint16_t> messageIds;
+        IdAllocator messageIds;
         uint16_t currentMessageId = 0;
 
         inet::ClockEvent* requestsCheckEvent = nullptr;
         std::map<uint16_t, RequestInfo> requests;
-        std::set<uint16_t> requestIds;
+        IdAllocator requestIds;
         uint16_t currentRequestId = 0;
+        std::set<uint32_t> readySubscribers;
 
-        inet::ClockEvent* registrationsCheckEvent = nullptr;
         std::map<uint16_t, RegisterInfo> registrations;
-        std::set<uint16_t> registrationIds;
+        IdAllocator registrationIds;
         uint16_t currentRegistrationId = 0;
 
-        std::map<std::pair<inet::L3Address, int>, SubscriberInfo> subscribers;
-        std::map<uint16_t, std::set<QoS>> topicIdToQoS;
-        std::map<std::pair<uint16_t, QoS>, std::set<std::pair<inet::L3Address, int>>> subscriptions;
+        inet::ClockEvent* retransmissionEvent = nullptr;
+        std::priority_queue<RetransmissionDeadline, std::vector<RetransmissionDeadline>, std::greater<RetransmissionDeadline>>
+                retransmissionDeadlines;
+
+        // publishers with batched acknowledgements; the hold time is fixed, so deadlines are queued in order
+        double ackBitmapWindow;
+        inet::ClockEvent* ackBitmapEvent = nullptr;
+        std::queue<SupervisionDeadline> ackBitmapDeadlines;
+
+        std::unordered_map<uint16_t, std::vector<SubscriptionInfo>> subscriptions;
+
+        // QoS -1 subscriber endpoints per predefined topic; updated per subscriber on subscription, registration and state changes
+        std::unordered_map<uint16_t, MinusOneRoute> minusOneRoutes;
 
-        // clear events
-        inet::ClockEvent* messagesClearEvent = nullptr;
+        // metrics attributes
+        unsigned multicastPublishMsgs = 0;
+        unsigned multicastSavedPublishMsgs = 0;
+        uint64_t multicastSavedBytes = 0;
 
     protected:
         // initialization
@@ -142,71 +169,89 @@ class MqttSNServer : public MqttSNApp
         virtual void processPubAck(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort);
         virtual void processPubRec(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort);
         virtual void processPubComp(inet::Packet* pk, const inet::L3Address& srcAddress, const int& srcPort);
+        virtual void processAckBitmap(inet::Packet* pk, ClientInfo* clientInfo);
 
         // outgoing packet handling
         virtual void sendAdvertise();
+        virtual uint8_t getLoadHint();
 
         virtual void sendBaseWithReturnCode(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, ReturnCode returnCode);
+        virtual void sendConnAck(const inet::L3Address& destAddress, const int& destPort, ClientInfo* clientInfo);
 
         virtual void sendMsgIdWithTopicIdPlus(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t topicId,
                                               uint16_t msgId, ReturnCode returnCode);
 
         virtual void sendBaseWithMsgId(const inet::L3Address& destAddress, const int& destPort, MsgType msgType, uint16_t msgId);
+        virtual void sendAckBitmap(const inet::L3Address& destAddress, const int& destPort, uint16_t msgId, uint32_t bitmap);
 
         virtual void sendSubAck(const inet::L3Address& destAddress, const int& destPort, QoS qosFlag, uint16_t topicId, uint16_t msgId,
-                                ReturnCode returnCode);
+                                ReturnCode returnCode, bool multicastFlag = false);
 
         virtual void sendRegister(const inet::L3Address& destAddress, const int& destPort, uint16_t topicId, uint16_t msgId,
                                   const std::string& topicName);
 
         virtual void sendPublish(const inet::L3Address& destAddress, const int& destPort, bool dupFlag, QoS qosFlag, bool retainFlag,
-                                 TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const std::string& data, const TagInfo& tagInfo);
+                                 TopicIdType topicIdTypeFlag, uint16_t topicId, uint16_t msgId, const PayloadBuffer& data, const TagInfo& tagInfo,
+                                 bool compressionFlag);
 
         // event handlers
         virtual void handleAdvertiseEvent();
 
-        virtual void handleActiveClientsCheckEvent();
-        virtual void handleAsleepClientsCheckEvent();
+        virtual void handleClientsSupervisionEvent();
         virtual void handlePendingRetainCheckEvent();
         virtual void handleRequestsCheckEvent();
-        virtual void handleRegistrationsCheckEvent();
+        virtual void handleRetransmissionEvent();
+        virtual void handleAckBitmapEvent();
         virtual void handleAwakenSubscriberCheckEvent(omnetpp::cMessage* msg);
 
-        virtual void handleMessagesClearEvent();
-
         // client methods
         virtual void cleanClientSession(const inet::L3Address& clientAddress, const int& clientPort, ClientType clientType);
         virtual void updateClientType(ClientInfo* clientInfo, ClientType clientType);
+        virtual void updateClientState(uint32_t clientHandle, ClientInfo* clientInfo, ClientState clientState);
+        virtual bool isConnectedState(ClientState clientState);
         virtual ClientInfo* addNewClient(const inet::L3Address& clientAddress, const int& clientPort);
         virtual ClientInfo* getClientInfo(const inet::L3Address& clientAddress, const int& clientPort);
+        virtual ClientInfo* getClientInfo(uint32_t clientHandle);
+        virtual uint32_t getClientHandle(const inet::L3Address& clientAddress, const int& clientPort);
+        virtual ClientSlot* getClientSlot(uint32_t clientHandle);
 
         // publisher methods
         virtual PublisherInfo* getPublisherInfo(const inet::L3Address& publisherAddress, const int& publisherPort, bool insertIfNotFound = false);
+        virtual void addPubAckToBitmap(uint32_t publisherHandle, PublisherInfo* publisherInfo, uint16_t msgId);
+        virtual void flushAckBitmap(ClientSlot* clientSlot);
+        virtual void armAckBitmapEvent();
 
         // topic methods
         virtual void fillWithPredefinedTopics();
         virtual void addNewTopic(const std::string& topicName, uint16_t topicId, TopicIdType topicIdType);
-        virtual void checkTopicsToIds(const std::string& topicName, uint16_t topicId);
-        virtual uint16_t getTopicByName(const std::string& topicName);
-        virtual TopicInfo getTopicById(uint16_t topicId);
         virtual TopicIdType getTopicIdType(uint16_t topicLength);
 
         // retain message methods
-        virtual void addNewRetainMessage(uint16_t topicId, bool dup, QoS qos, TopicIdType topicIdType, const std::string& data);
+        virtual void addNewRetainMessage(uint16_t topicId, bool dup, QoS qos, TopicIdType topicIdType, const PayloadBuffer& data, bool compressed);
         virtual void addNewPendingRetainMessage(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId, QoS qos);
 
         // message methods
         virtual void addNewMessage(const MessageInfo& messageInfo);
         virtual void addAndMarkMessage(const MessageInfo& messageInfo, bool& isMessageAdded);
-        virtual void deleteMessage(std::map<uint16_t, MessageInfo>::iterator& messageIt, std::set<uint16_t>::iterator& messageIdIt);
-        virtual void deleteAllocatedMessages(const std::vector<MessageInfo*>& messages);
+        virtual void deleteMessage(std::map<uint16_t, MessageInfo>::iterator& messageIt);
+        virtual void addMessageReference(uint16_t messageId);
+        virtual void releaseMessageReference(uint16_t messageId);
 
         // request message methods
-        virtual MessageInfo* getRequestMessageInfo(const RequestInfo& requestInfo, std::vector<MessageInfo*>& allocatedObjects);
+        virtual const MessageInfo* getRequestMessageInfo(const RequestInfo& requestInfo);
 
         // request handling methods
+        virtual void processSubscriberRequests(ClientSlot* clientSlot);
+
+        virtual void retransmitRequest(ClientSlot* clientSlot, std::map<uint16_t, RequestInfo>::iterator& requestIt,
+                                       const MessageInfo* messageInfo, QoS subscriptionQoS);
+
+        virtual void handleRequestDeadline(const RetransmissionDeadline& retransmissionDeadline);
         virtual void dispatchPublishToSubscribers(const MessageInfo& messageInfo);
 
+        virtual void dispatchPublishToSubscriber(ClientSlot* clientSlot, QoS subscriptionQoS, const MessageInfo& messageInfo,
+                                                 bool& isMessageAdded);
+
         virtual void processRequestForActiveSubscriber(const inet::L3Address& subscriberAddress, int subscriberPort,
                                                        const MessageInfo& messageInfo, QoS resultQoS, bool& isMessageAdded);
 
@@ -222,30 +267,41 @@ class MqttSNServer : public MqttSNApp
         virtual void addNewRequest(const inet::L3Address& subscriberAddress, const int& subscriberPort, MsgType messageType, bool sendAtLeastOnce,
                                    uint16_t messagesKey = 0, uint16_t retainMessagesKey = 0);
 
-        virtual void deleteRequest(std::map<uint16_t, RequestInfo>::iterator& requestIt, std::set<uint16_t>::iterator& requestIdIt);
-
-        virtual bool isValidRequest(uint16_t requestId, MsgType messageType, std::map<uint16_t, RequestInfo>::iterator& requestIt,
-                                    std::set<uint16_t>::iterator& requestIdIt);
-
+        virtual void deleteRequest(std::map<uint16_t, RequestInfo>::iterator& requestIt);
+        virtual bool isValidRequest(uint16_t requestId, MsgType messageType, std::map<uint16_t, RequestInfo>::iterator& requestIt);
         virtual bool processRequestAck(uint16_t requestId, MsgType messageType);
 
         // registration methods
         virtual void manageRegistration(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId);
 
-        virtual void addNewRegistration(const inet::L3Address& subscriberAddress, const int& subscriberPort, const std::string& topicName,
-                                        uint16_t topicId);
+        virtual void addNewRegistration(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId);
 
-        virtual void deleteRegistration(std::map<uint16_t, RegisterInfo>::iterator& registrationIt, std::set<uint16_t>::iterator& registrationIdIt);
+        virtual void deleteRegistration(std::map<uint16_t, RegisterInfo>::iterator& registrationIt);
         virtual bool processRegistrationAck(uint16_t registrationId);
+        virtual void handleRegistrationDeadline(const RetransmissionDeadline& retransmissionDeadline);
+
+        // client supervision methods
+        virtual void refreshClientActivity(uint32_t clientHandle, ClientInfo* clientInfo);
+        virtual void updateClientSupervision(uint32_t clientHandle, ClientInfo* clientInfo);
+        virtual void queueClientSupervision(uint32_t clientHandle, ClientInfo* clientInfo);
+        virtual void expireClientSupervision(ClientSlot* clientSlot, uint32_t clientHandle);
+        virtual void armClientsSupervisionEvent();
+
+        // retransmission deadline methods
+        virtual void addRetransmissionDeadline(inet::clocktime_t deadline, bool isRegistration, uint16_t id);
+        virtual void sampleRoundTripTime(uint32_t subscriberHandle, inet::clocktime_t requestTime, int retransmissionCounter);
+        virtual void armRetransmissionEvent();
 
         // subscriber methods
         virtual void setAllSubscriberTopics(const inet::L3Address& subscriberAddress, const int& subscriberPort, bool isRegistered,
                                             bool skipPredefinedTopics = true);
 
         virtual void handleSubscriberPingRequest(const inet::L3Address& subscriberAddress, const int& subscriberPort);
+        virtual void markSubscriberReady(uint32_t subscriberHandle);
 
         virtual void manageAwakenSubscriberEvent(const inet::L3Address& subscriberAddress, const int& subscriberPort,
                                                  SubscriberInfo* subscriberInfo);
+        virtual inet::clocktime_t getLatestRequestDeadline(const SubscriberInfo* subscriberInfo);
 
         virtual bool isTopicRegisteredForSubscriber(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId);
 
@@ -254,24 +310,32 @@ class MqttSNServer : public MqttSNApp
 
         virtual SubscriberTopicInfo* getSubscriberTopicInfo(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId);
         virtual ClientInfo* getSubscriberClientInfo(const inet::L3Address& subscriberAddress, const int& subscriberPort);
+        virtual ClientSlot* getSubscriberClientSlot(uint32_t subscriberHandle);
 
         // subscription methods
         virtual void deleteSubscriptionIfExists(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId);
 
         virtual bool findSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId,
-                                      std::pair<uint16_t, QoS>& subscriptionKey);
+                                      QoS& subscriptionQoS);
 
         virtual bool insertSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId,
                                         TopicIdType topicIdType, QoS qos);
 
-        virtual bool deleteSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort,
-                                        const std::pair<uint16_t, QoS>& subscriptionKey);
+        virtual bool deleteSubscription(const inet::L3Address& subscriberAddress, const int& subscriberPort, uint16_t topicId);
+
+        // multicast methods
+        virtual bool isMulticastPublish(const MessageInfo& messageInfo);
+        virtual bool isMulticastReadySubscriber(ClientSlot* clientSlot, uint16_t topicId);
+        virtual int countMulticastReadySubscribers(const std::vector<SubscriptionInfo>& topicSubscriptions, uint16_t topicId);
+        virtual void sendMulticastPublish(const MessageInfo& messageInfo, int fanOut);
 
-        virtual std::set<std::pair<uint16_t, QoS>> getSubscriptionKeysByTopicId(uint16_t topicId);
+        // QoS -1 fast path methods
+        virtual void updateMinusOneRoute(uint16_t topicId, uint32_t subscriberHandle);
+        virtual void updateMinusOneRoutes(uint32_t subscriberHandle);
+        virtual void removeFromMinusOneRoute(uint16_t topicId, SubscriberTopicInfo* subscriberTopicInfo);
 
         // congestion methods
         virtual bool checkClientsCongestion();
-        virtual bool checkIDSpaceCongestion(const std::set<uint16_t>& usedIds, bool allowMaxValue = true);
         virtual bool checkPublishCongestion(QoS qos, bool retain);
 
         // clear methods
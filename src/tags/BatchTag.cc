@@ -0,0 +1,15 @@
+#include "BatchTag.h"
+
+namespace mqttsn {
+
+void BatchTag::setSamples(const std::shared_ptr<const std::vector<TagInfo>>& sampleTags)
+{
+    samples = sampleTags;
+}
+
+const std::shared_ptr<const std::vector<TagInfo>>& BatchTag::getSamples() const
+{
+    return samples;
+}
+
+} /* namespace mqttsn */
@@ -0,0 +1,26 @@
+#ifndef TAGS_BATCHTAG_H_
+#define TAGS_BATCHTAG_H_
+
+#include "inet/common/TagBase_m.h"
+#include "inet/common/clock/ClockUserModuleMixin.h"
+#include "types/shared/TagInfo.h"
+
+namespace mqttsn {
+
+class BatchTag : public inet::TagBase
+{
+    private:
+        std::shared_ptr<const std::vector<TagInfo>> samples;
+
+    public:
+        BatchTag() {};
+
+        void setSamples(const std::shared_ptr<const std::vector<TagInfo>>& sampleTags);
+        const std::shared_ptr<const std::vector<TagInfo>>& getSamples() const;
+
+        ~BatchTag() {};
+};
+
+} /* namespace mqttsn */
+
+#endif /* TAGS_BATCHTAG_H_ */
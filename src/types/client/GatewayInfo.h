@@ -6,6 +6,8 @@ struct GatewayInfo {
     int port = 0;
     uint16_t duration = 0;
     inet::clocktime_t lastUpdatedTime = 0;
+    uint8_t loadHint = 0; // load percentage plus one; zero when the gateway does not report its load
+    double smoothedRtt = 0; // zero until a round trip with the gateway is measured
 };
 
 #endif /* TYPES_CLIENT_GATEWAYINFO_H_ */
@@ -0,0 +1,11 @@
+#ifndef TYPES_CLIENT_GATEWAYSELECTIONPOLICYTYPE_H_
+#define TYPES_CLIENT_GATEWAYSELECTIONPOLICYTYPE_H_
+
+enum GatewaySelectionPolicyType {
+    RANDOM_POLICY,
+    LOWEST_RTT_POLICY,
+    LEAST_LOADED_POLICY,
+    STICKY_POLICY
+};
+
+#endif /* TYPES_CLIENT_GATEWAYSELECTIONPOLICYTYPE_H_ */
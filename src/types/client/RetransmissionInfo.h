@@ -4,8 +4,14 @@
 struct RetransmissionInfo {
     inet::ClockEvent *retransmissionEvent = nullptr;
     int retransmissionCounter = 0;
+    inet::clocktime_t sendTime = 0;
     inet::L3Address destAddress;
     int destPort = 0;
+    MsgType msgType = MsgType::ADVERTISE;
+    uint16_t msgId = 0; // zero for messages without an ID
+    bool hasSleepDuration = false; // used only for DISCONNECT
+    uint16_t sleepDuration = 0;
+    bool hasClientId = false; // used only for PINGREQ
 };
 
 #endif /* TYPES_CLIENT_RETRANSMISSIONINFO_H_ */
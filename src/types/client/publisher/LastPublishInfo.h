@@ -7,6 +7,10 @@ struct LastPublishInfo {
     ItemInfo* itemInfo = nullptr;
     DataInfo* dataInfo = nullptr;
     TagInfo tagInfo;
+    std::string batchData = ""; // packed samples of a batched publication, empty otherwise
+    bool encoded = false; // the codec already ran; retransmissions resend the stored result
+    bool compressed = false;
+    std::string encodedData = ""; // codec output when compressed, empty otherwise
     bool retry = false;
 };
 
@@ -0,0 +1,11 @@
+#ifndef TYPES_CLIENT_PUBLISHER_PUBLISHBATCHINFO_H_
+#define TYPES_CLIENT_PUBLISHER_PUBLISHBATCHINFO_H_
+
+struct PublishBatchInfo {
+    LastPublishInfo publishInfo; // first sample; provides topic, QoS and retain flag of the batch
+    std::string samples = ""; // length-prefixed sample data
+    std::vector<TagInfo> sampleTags;
+    inet::clocktime_t creationTime = 0;
+};
+
+#endif /* TYPES_CLIENT_PUBLISHER_PUBLISHBATCHINFO_H_ */
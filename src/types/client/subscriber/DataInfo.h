@@ -7,6 +7,7 @@ struct DataInfo {
     TopicIdType topicIdType = TopicIdType::NORMAL_TOPIC_ID;
     bool retain = false;
     std::string data = "";
+    std::vector<std::string> samples; // individual samples of a batched publication, empty otherwise
     TagInfo tagInfo;
 };
 
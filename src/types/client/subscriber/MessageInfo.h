@@ -9,6 +9,7 @@ struct MessageInfo {
     QoS qos = QoS::QOS_ZERO;
     bool retain = false;
     std::string data = "";
+    std::vector<std::string> samples; // individual samples of a batched publication, empty otherwise
     TagInfo tagInfo;
 };
 
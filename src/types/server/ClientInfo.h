@@ -9,6 +9,9 @@ struct ClientInfo {
     ClientState currentState = ClientState::DISCONNECTED;
     inet::clocktime_t lastReceivedMsgTime = 0;
     bool sentPingReq = false;
+    bool ackBitmap = false;
+    inet::clocktime_t supervisionDeadline = 0;
+    inet::clocktime_t queuedSupervisionDeadline = 0;
 };
 
 #endif /* TYPES_SERVER_CLIENTINFO_H_ */
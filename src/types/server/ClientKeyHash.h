@@ -0,0 +1,17 @@
+#ifndef TYPES_SERVER_CLIENTKEYHASH_H_
+#define TYPES_SERVER_CLIENTKEYHASH_H_
+
+struct ClientKeyHash {
+    size_t operator()(const std::pair<inet::L3Address, int>& clientKey) const
+    {
+        const inet::L3Address& address = clientKey.first;
+
+        // IPv4 addresses hash directly; other address types fall back to their string form
+        size_t addressHash = (address.getType() == inet::L3Address::IPv4) ?
+                address.toIpv4().getInt() : std::hash<std::string>()(address.str());
+
+        return addressHash * 31 + clientKey.second;
+    }
+};
+
+#endif /* TYPES_SERVER_CLIENTKEYHASH_H_ */
@@ -0,0 +1,14 @@
+#ifndef TYPES_SERVER_CLIENTSLOT_H_
+#define TYPES_SERVER_CLIENTSLOT_H_
+
+struct ClientSlot {
+    inet::L3Address clientAddress;
+    int clientPort = 0;
+    ClientInfo clientInfo;
+    bool isPublisher = false;
+    PublisherInfo publisherInfo;
+    bool isSubscriber = false;
+    SubscriberInfo subscriberInfo;
+};
+
+#endif /* TYPES_SERVER_CLIENTSLOT_H_ */
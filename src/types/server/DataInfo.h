@@ -5,7 +5,8 @@ struct DataInfo {
     uint16_t topicId = 0;
     TopicIdType topicIdType = TopicIdType::NORMAL_TOPIC_ID;
     bool retain = false;
-    std::string data = "";
+    PayloadBuffer data;
+    bool compressed = false;
     TagInfo tagInfo;
 };
 
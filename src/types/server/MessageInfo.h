@@ -7,8 +7,10 @@ struct MessageInfo {
     bool dup = false;
     QoS qos = QoS::QOS_ZERO;
     bool retain = false;
-    std::string data = "";
+    PayloadBuffer data;
+    bool compressed = false; // data is passed through as received; only subscribers decompress it
     TagInfo tagInfo;
+    int referenceCounter = 0;
 };
 
 #endif /* TYPES_SERVER_MESSAGEINFO_H_ */
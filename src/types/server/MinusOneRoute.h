@@ -0,0 +1,10 @@
+#ifndef TYPES_SERVER_MINUSONEROUTE_H_
+#define TYPES_SERVER_MINUSONEROUTE_H_
+
+struct MinusOneRoute {
+    std::vector<uint32_t> readyHandles;
+    std::vector<std::pair<inet::L3Address, int>> readyEndpoints; // parallel to the ready handles
+    std::vector<uint32_t> pendingHandles; // asleep or unregistered subscribers; served through the buffered path
+};
+
+#endif /* TYPES_SERVER_MINUSONEROUTE_H_ */
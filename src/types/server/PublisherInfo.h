@@ -8,6 +8,10 @@ struct PublisherInfo {
     std::string willTopic = "";
     std::string willMsg = "";
     std::map<uint16_t, DataInfo> messages;
+
+    // batched QoS 1 acknowledgements when bitmap acknowledgements are negotiated
+    AckBitmapAccumulator ackBitmap;
+    inet::clocktime_t ackBitmapDeadline = 0;
 };
 
 #endif /* TYPES_SERVER_PUBLISHERINFO_H_ */
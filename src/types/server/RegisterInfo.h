@@ -3,10 +3,9 @@
 
 struct RegisterInfo {
     inet::clocktime_t requestTime = 0;
+    inet::clocktime_t deadline = 0;
     int retransmissionCounter = 0;
-    inet::L3Address subscriberAddress;
-    int subscriberPort = 0;
-    std::string topicName = "";
+    uint32_t subscriberHandle = 0;
     uint16_t topicId = 0;
 };
 
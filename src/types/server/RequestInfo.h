@@ -3,9 +3,9 @@
 
 struct RequestInfo {
     inet::clocktime_t requestTime = 0;
+    inet::clocktime_t deadline = 0;
     int retransmissionCounter = 0;
-    inet::L3Address subscriberAddress;
-    int subscriberPort = 0;
+    uint32_t subscriberHandle = 0;
     MsgType messageType = MsgType::PUBLISH;
     bool sendAtLeastOnce = true;
     uint16_t messagesKey = 0;
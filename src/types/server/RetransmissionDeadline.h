@@ -0,0 +1,15 @@
+#ifndef TYPES_SERVER_RETRANSMISSIONDEADLINE_H_
+#define TYPES_SERVER_RETRANSMISSIONDEADLINE_H_
+
+struct RetransmissionDeadline {
+    inet::clocktime_t deadline = 0;
+    bool isRegistration = false;
+    uint16_t id = 0;
+
+    bool operator>(const RetransmissionDeadline& other) const
+    {
+        return deadline > other.deadline;
+    }
+};
+
+#endif /* TYPES_SERVER_RETRANSMISSIONDEADLINE_H_ */
@@ -3,6 +3,7 @@
 
 struct SubscriberInfo {
     std::map<uint16_t, SubscriberTopicInfo> subscriberTopics;
+    std::set<uint16_t> requestIds;
     inet::ClockEvent* awakenSubscriberCheckEvent = nullptr;
     inet::clocktime_t awakenSubscriberCheckStartTime = 0;
 };
@@ -4,6 +4,11 @@
 struct SubscriberTopicInfo {
     TopicIdType topicIdType = TopicIdType::NORMAL_TOPIC_ID;
     bool isRegistered = false;
+    QoS qos = QoS::QOS_ZERO;
+    size_t subscriptionIndex = 0;
+    bool inMinusOneRoute = false;
+    bool minusOneRouteReady = false; // listed in the ready rather than the pending handles
+    size_t minusOneRouteIndex = 0;
 };
 
 #endif /* TYPES_SERVER_SUBSCRIBERTOPICINFO_H_ */
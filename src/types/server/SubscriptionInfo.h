@@ -0,0 +1,9 @@
+#ifndef TYPES_SERVER_SUBSCRIPTIONINFO_H_
+#define TYPES_SERVER_SUBSCRIPTIONINFO_H_
+
+struct SubscriptionInfo {
+    uint32_t subscriberHandle = 0;
+    QoS qos = QoS::QOS_ZERO;
+};
+
+#endif /* TYPES_SERVER_SUBSCRIPTIONINFO_H_ */
@@ -0,0 +1,14 @@
+#ifndef TYPES_SERVER_SUPERVISIONDEADLINE_H_
+#define TYPES_SERVER_SUPERVISIONDEADLINE_H_
+
+struct SupervisionDeadline {
+    inet::clocktime_t deadline = 0;
+    uint32_t clientHandle = 0;
+
+    bool operator>(const SupervisionDeadline& other) const
+    {
+        return deadline > other.deadline;
+    }
+};
+
+#endif /* TYPES_SERVER_SUPERVISIONDEADLINE_H_ */
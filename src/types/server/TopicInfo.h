@@ -2,8 +2,8 @@
 #define TYPES_SERVER_TOPICINFO_H_
 
 struct TopicInfo {
-    std::string topicName = "";
     TopicIdType topicIdType = TopicIdType::NORMAL_TOPIC_ID;
+    bool multicast = false;
 };
 
 #endif /* TYPES_SERVER_TOPICINFO_H_ */
@@ -0,0 +1,9 @@
+#ifndef TYPES_SHARED_COALESCEDPACKETINFO_H_
+#define TYPES_SHARED_COALESCEDPACKETINFO_H_
+
+struct CoalescedPacketInfo {
+    inet::Packet* packet = nullptr;
+    inet::clocktime_t flushTime = 0;
+};
+
+#endif /* TYPES_SHARED_COALESCEDPACKETINFO_H_ */
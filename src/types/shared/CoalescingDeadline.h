@@ -0,0 +1,10 @@
+#ifndef TYPES_SHARED_COALESCINGDEADLINE_H_
+#define TYPES_SHARED_COALESCINGDEADLINE_H_
+
+struct CoalescingDeadline {
+    inet::clocktime_t flushTime = 0;
+    inet::L3Address destAddress;
+    int destPort = 0;
+};
+
+#endif /* TYPES_SHARED_COALESCINGDEADLINE_H_ */
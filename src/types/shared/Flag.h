@@ -3,9 +3,12 @@
 
 enum Flag : uint16_t {
     TOPIC_ID_TYPE = 0,
+    ACK_BITMAP = 0, // CONNECT and CONNACK extensions only, where the topic ID type bits are unused
     CLEAN_SESSION = 2,
     WILL = 3,
+    COMPRESSION = 3, // PUBLISH only, where the will bit is unused
     RETAIN = 4,
+    MULTICAST = 4, // SUBACK extension only, where the retain bit is unused
     QUALITY_OF_SERVICE = 5,
     DUP = 7
 };
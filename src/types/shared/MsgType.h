@@ -28,7 +28,8 @@ enum MsgType : uint8_t {
     WILLTOPICUPD = 0x1A,
     WILLTOPICRESP = 0x1B,
     WILLMSGUPD = 0x1C,
-    WILLMSGRESP = 0x1D
+    WILLMSGRESP = 0x1D,
+    ACKBITMAP = 0x1E // extension negotiated at CONNECT
 };
 
 #endif /* TYPES_MSGTYPE_H_ */
@@ -0,0 +1,7 @@
+#ifndef TYPES_SHARED_PAYLOADBUFFER_H_
+#define TYPES_SHARED_PAYLOADBUFFER_H_
+
+// immutable payload bytes shared by stored messages and outgoing chunks
+using PayloadBuffer = std::shared_ptr<const std::string>;
+
+#endif /* TYPES_SHARED_PAYLOADBUFFER_H_ */
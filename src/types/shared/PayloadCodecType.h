@@ -0,0 +1,10 @@
+#ifndef TYPES_SHARED_PAYLOADCODECTYPE_H_
+#define TYPES_SHARED_PAYLOADCODECTYPE_H_
+
+// codec identifiers; the first octet of a compressed payload
+enum PayloadCodecType : uint8_t {
+    NO_CODEC = 0x00,
+    DICTIONARY_CODEC = 0x01
+};
+
+#endif /* TYPES_SHARED_PAYLOADCODECTYPE_H_ */
@@ -0,0 +1,10 @@
+#ifndef TYPES_SHARED_SIGHTINGTYPE_H_
+#define TYPES_SHARED_SIGHTINGTYPE_H_
+
+enum SightingType {
+    NEW_SIGHTING,
+    DUPLICATE_SIGHTING,
+    STALE_SIGHTING // older than the tracked window; neither new nor duplicate can be told
+};
+
+#endif /* TYPES_SHARED_SIGHTINGTYPE_H_ */
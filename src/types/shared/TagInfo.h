@@ -4,6 +4,7 @@
 struct TagInfo {
     inet::clocktime_t timestamp = 0;
     unsigned identifier = 0;
+    std::shared_ptr<const std::vector<TagInfo>> samples; // tags of the individual samples of a batched publication
 };
 
 #endif /* TYPES_SHARED_TAGINFO_H_ */